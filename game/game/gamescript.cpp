@@ -1487,7 +1487,7 @@ void GameScript::wld_isfpavailable(Daedalus::DaedalusVM &vm) {
     return;
     }
 
-  auto wp = world().findFreePoint(*self,name.c_str());
+  auto wp = world().findFreePoint(*self,StrId(name.c_str()));
   vm.setReturn(wp ? 1 : 0);
   }
 
@@ -1499,7 +1499,7 @@ void GameScript::wld_isnextfpavailable(Daedalus::DaedalusVM &vm) {
     vm.setReturn(0);
     return;
     }
-  auto fp = world().findNextFreePoint(*self,name.c_str());
+  auto fp = world().findNextFreePoint(*self,StrId(name.c_str()));
   vm.setReturn(fp ? 1 : 0);
   }
 
@@ -2864,7 +2864,7 @@ void GameScript::ai_gotofp(Daedalus::DaedalusVM &vm) {
   auto npc      = popInstance(vm);
 
   if(npc) {
-    auto to = world().findFreePoint(*npc,waypoint.c_str());
+    auto to = world().findFreePoint(*npc,StrId(waypoint.c_str()));
     if(to!=nullptr)
       npc->aiPush(AiQueue::aiGoToPoint(*to));
     }
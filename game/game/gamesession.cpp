@@ -107,18 +107,26 @@ GameSession::GameSession(Serialize &fin) {
   for(size_t i=0;i<wssSize;++i)
     visitedWorlds.emplace_back(fin);
 
-  vm.reset(new GameScript(*this,fin));
-  setWorld(std::unique_ptr<World>(new World(*this,fin,[&](int v){
-    Gothic::inst().setLoadingProgress(int(v*0.55));
-    })));
-
-  vm->initDialogs();
-  Gothic::inst().setLoadingProgress(70);
-  wrld->load(fin);
-  vm->loadVar(fin);
+  fin.readSection([&](){
+    vm.reset(new GameScript(*this,fin));
+    });
+  fin.readSection([&](){
+    setWorld(std::unique_ptr<World>(new World(*this,fin,[&](int v){
+      Gothic::inst().setLoadingProgress(int(v*0.55));
+      })));
+
+    vm->initDialogs();
+    Gothic::inst().setLoadingProgress(70);
+    wrld->load(fin);
+    });
+  fin.readSection([&](){
+    vm->loadVar(fin);
+    });
   if(auto hero = wrld->player())
     vm->setInstanceNPC("HERO",*hero);
-  cam->load(fin,wrld->player());
+  fin.readSection([&](){
+    cam->load(fin,wrld->player());
+    });
   Gothic::inst().setLoadingProgress(96);
   }
 
@@ -142,14 +150,22 @@ void GameSession::save(Serialize &fout, const char* name, const Pixmap& screen)
     i.save(fout);
   Gothic::inst().setLoadingProgress(25);
 
-  vm->save(fout);
+  fout.writeSection([&](){
+    vm->save(fout);
+    });
   Gothic::inst().setLoadingProgress(60);
-  if(wrld)
-    wrld->save(fout);
+  fout.writeSection([&](){
+    if(wrld)
+      wrld->save(fout);
+    });
 
   Gothic::inst().setLoadingProgress(80);
-  vm->saveVar(fout);
-  cam->save(fout);
+  fout.writeSection([&](){
+    vm->saveVar(fout);
+    });
+  fout.writeSection([&](){
+    cam->save(fout);
+    });
   }
 
 void GameSession::setWorld(std::unique_ptr<World> &&w) {
@@ -288,7 +304,7 @@ auto GameSession::implChangeWorld(std::unique_ptr<GameSession>&& game,
     Gothic::inst().setLoadingProgress(v);
     };
 
-  Tempest::MemReader rd{wss.storage.data(),wss.storage.size()};
+  Tempest::MemReader rd{wss.data(),wss.size()};
   Serialize          fin = wss.isEmpty() ? Serialize::empty() : Serialize{rd};
 
   std::unique_ptr<World> ret;
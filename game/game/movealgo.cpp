@@ -11,6 +11,7 @@ const float   MoveAlgo::gravity               = DynamicWorld::gravity;
 const float   MoveAlgo::eps                   = 2.f;   // 2-santimeters
 const float   MoveAlgo::epsAni                = 0.25f; // 25-millimeters
 const int32_t MoveAlgo::flyOverWaterHint      = 999999;
+const uint64_t MoveAlgo::maxStepDt            = 50;    // milliseconds
 
 MoveAlgo::MoveAlgo(Npc& unit)
   :npc(unit) {
@@ -317,7 +318,11 @@ void MoveAlgo::tickSwim(uint64_t dt) {
   }
 
 void MoveAlgo::tick(uint64_t dt, MvFlags moveFlg) {
-  implTick(dt,moveFlg);
+  // long dt of ai-lod sliced npc is split: ground probes and collision tests are valid for short moves only
+  for(stepOffset=0; dt-stepOffset>maxStepDt; stepOffset+=maxStepDt)
+    implTick(maxStepDt,moveFlg);
+  implTick(dt-stepOffset,moveFlg);
+  stepOffset = 0;
 
   if(cache.sector!=nullptr && portal!=cache.sector) {
     formerPortal = portal;
@@ -496,13 +501,13 @@ void MoveAlgo::applyRotation(Tempest::Vec3& out, const Tempest::Vec3& dpos, floa
   }
 
 Tempest::Vec3 MoveAlgo::animMoveSpeed(uint64_t dt) const {
-  auto dp = npc.animMoveSpeed(dt);
+  auto dp = npc.animMoveSpeed(dt,stepOffset);
   Tempest::Vec3 ret;
   applyRotation(ret,dp);
   return ret;
   }
 
-Tempest::Vec3 MoveAlgo::npcMoveSpeed(uint64_t dt, MvFlags moveFlg) {
+Tempest::Vec3 MoveAlgo::npcMoveSpeed(uint64_t dt, MvFlags moveFlg) const {
   Tempest::Vec3 dp = animMoveSpeed(dt);
   if(!npc.isFlyAnim())
     dp.y = 0.f;
@@ -527,11 +532,11 @@ Tempest::Vec3 MoveAlgo::npcMoveSpeed(uint64_t dt, MvFlags moveFlg) {
   return dp;
   }
 
-Tempest::Vec3 MoveAlgo::go2NpcMoveSpeed(const Tempest::Vec3& dp,const Npc& tg) {
+Tempest::Vec3 MoveAlgo::go2NpcMoveSpeed(const Tempest::Vec3& dp,const Npc& tg) const {
   return go2WpMoveSpeed(dp,tg.position());
   }
 
-Tempest::Vec3 MoveAlgo::go2WpMoveSpeed(Tempest::Vec3 dp, const Tempest::Vec3& to) {
+Tempest::Vec3 MoveAlgo::go2WpMoveSpeed(Tempest::Vec3 dp, const Tempest::Vec3& to) const {
   auto  d    = to-npc.position();
   float qLen = (d.x*d.x+d.z*d.z);
 
@@ -899,6 +904,56 @@ void MoveAlgo::onMoveFailed(const Tempest::Vec3& dp, const DynamicWorld::Collisi
     }
   }
 
+bool MoveAlgo::prefetchRays(DynamicWorld::RayBatch& rb, uint64_t dt) {
+  // same probes, as first step of implTick is going to cast; mispredicted ones are cast again by tick
+  if((flags&(JumpUp|ClimbUp|Swim|Dive))!=NoFlags || npc.interactive()!=nullptr)
+    return false;
+  if(isInAir() && npc.isJumpAnim())
+    return false;
+
+  const float fallThreshold = stepHeight();
+  const auto  pos           = npc.position();
+  if(isInAir() || isSlide()) {
+    // tickGravity, tickSlide
+    prefetchLand  = pos+Tempest::Vec3(0,fallThreshold,0);
+    prefetchWater = pos;
+    } else {
+    // moving npc, by animation
+    auto dp       = skipMove+npcMoveSpeed(std::min(dt,maxStepDt),NoFlag);
+    prefetchLand  = pos+dp+Tempest::Vec3(0,fallThreshold,0);
+    prefetchWater = pos+dp;
+    }
+
+  auto& l = prefetchLand;
+  auto& w = prefetchWater;
+  bool land  = std::fabs(cache.x-l.x)>eps  || std::fabs(cache.y-l.y)>eps  || std::fabs(cache.z-l.z)>eps;
+  bool water = std::fabs(cacheW.x-w.x)>eps || std::fabs(cacheW.y-w.y)>eps || std::fabs(cacheW.z-w.z)>eps;
+  if(!land && !water)
+    return false;
+  rb.addLand(l,rayDepth());
+  rb.addWater(w);
+  return true;
+  }
+
+void MoveAlgo::applyRays(const DynamicWorld::RayBatch& rb, size_t id) {
+  static_cast<DynamicWorld::RayLandResult&>(cache) = rb.land(id);
+  cache.x = prefetchLand.x;
+  cache.y = prefetchLand.y;
+  cache.z = prefetchLand.z;
+
+  static_cast<DynamicWorld::RayWaterResult&>(cacheW) = rb.water(id+1);
+  cacheW.x = prefetchWater.x;
+  cacheW.y = prefetchWater.y;
+  cacheW.z = prefetchWater.z;
+  prefetch = RP_Pending;
+  }
+
+MoveAlgo::RayPrefetch MoveAlgo::takeRayPrefetch() {
+  auto ret = prefetch;
+  prefetch = RP_None;
+  return ret;
+  }
+
 float MoveAlgo::waterRay(const Tempest::Vec3& pos, bool* hasCol) const {
   if(std::fabs(cacheW.x-pos.x)>eps || std::fabs(cacheW.y-pos.y)>eps || std::fabs(cacheW.z-pos.z)>eps) {
     static_cast<DynamicWorld::RayWaterResult&>(cacheW) = npc.world().physic()->waterRay(pos);
@@ -911,12 +966,18 @@ float MoveAlgo::waterRay(const Tempest::Vec3& pos, bool* hasCol) const {
   return cacheW.wdepth;
   }
 
+float MoveAlgo::rayDepth() const {
+  if(fallSpeed.y<0)
+    return 0; // whole world
+  return waterDepthChest()+100;  // 1 meter extra offset
+  }
+
 void MoveAlgo::rayMain(const Tempest::Vec3& pos) const {
-  if(std::fabs(cache.x-pos.x)>eps || std::fabs(cache.y-pos.y)>eps || std::fabs(cache.z-pos.z)>eps) {
-    float dy = waterDepthChest()+100;  // 1 meter extra offset
-    if(fallSpeed.y<0)
-      dy = 0; // whole world
-    static_cast<DynamicWorld::RayLandResult&>(cache) = npc.world().physic()->landRay(pos,dy);
+  const bool miss = std::fabs(cache.x-pos.x)>eps || std::fabs(cache.y-pos.y)>eps || std::fabs(cache.z-pos.z)>eps;
+  if(prefetch==RP_Pending)
+    prefetch = miss ? RP_Miss : RP_Hit;
+  if(miss) {
+    static_cast<DynamicWorld::RayLandResult&>(cache) = npc.world().physic()->landRay(pos,rayDepth());
     cache.x = pos.x;
     cache.y = pos.y;
     cache.z = pos.z;
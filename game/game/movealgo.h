@@ -42,6 +42,18 @@ class MoveAlgo final {
 
     void    tick(uint64_t dt, MvFlags fai=NoFlag);
 
+    enum RayPrefetch : uint8_t {
+      RP_None,
+      RP_Pending,
+      RP_Hit,
+      RP_Miss,
+      };
+
+    // ground and water probes of next tick, predicted and resolved in batch before tick
+    bool    prefetchRays(DynamicWorld::RayBatch& rb, uint64_t dt);
+    void    applyRays   (const DynamicWorld::RayBatch& rb, size_t id);
+    auto    takeRayPrefetch() -> RayPrefetch;
+
     void    multSpeed(float s){ mulSpeed=s; }
     void    clearSpeed();
     void    accessDamFly(float dx,float dz);
@@ -113,9 +125,9 @@ class MoveAlgo final {
     void    applyRotation(Tempest::Vec3& out, const Tempest::Vec3& in) const;
     void    applyRotation(Tempest::Vec3& out, const Tempest::Vec3& in, float radians) const;
     auto    animMoveSpeed(uint64_t dt) const -> Tempest::Vec3;
-    auto    npcMoveSpeed (uint64_t dt, MvFlags moveFlg) -> Tempest::Vec3;
-    auto    go2NpcMoveSpeed (const Tempest::Vec3& dp, const Npc &tg) -> Tempest::Vec3;
-    auto    go2WpMoveSpeed  (Tempest::Vec3 dp, const Tempest::Vec3& to) -> Tempest::Vec3;
+    auto    npcMoveSpeed (uint64_t dt, MvFlags moveFlg) const -> Tempest::Vec3;
+    auto    go2NpcMoveSpeed (const Tempest::Vec3& dp, const Npc &tg) const -> Tempest::Vec3;
+    auto    go2WpMoveSpeed  (Tempest::Vec3 dp, const Tempest::Vec3& to) const -> Tempest::Vec3;
     void    implTick(uint64_t dt,MvFlags fai=NoFlag);
 
     float   stepHeight()  const;
@@ -125,6 +137,7 @@ class MoveAlgo final {
 
     void    emitWaterSplash(float y);
 
+    float   rayDepth () const;
     void    rayMain  (const Tempest::Vec3& pos) const;
     float   dropRay  (const Tempest::Vec3& pos, bool& hasCol) const;
     float   waterRay (const Tempest::Vec3& pos, bool* hasCol = nullptr) const;
@@ -140,6 +153,9 @@ class MoveAlgo final {
     Npc&                npc;
     mutable CacheLand   cache;
     mutable CacheWater  cacheW;
+    mutable RayPrefetch prefetch = RP_None;
+    Tempest::Vec3       prefetchLand  = {};
+    Tempest::Vec3       prefetchWater = {};
 
     std::string_view    portal;
     std::string_view    formerPortal;
@@ -158,9 +174,11 @@ class MoveAlgo final {
 
     uint64_t            diveStart  = 0;
     uint64_t            lastBounce = 0;
+    uint64_t            stepOffset = 0; // start of current sub-step, within tick
 
     static const float   gravity;
     static const float   eps;
     static const float   epsAni;
     static const int32_t flyOverWaterHint;
+    static const uint64_t maxStepDt;
   };
@@ -0,0 +1,351 @@
+#include "savefile.h"
+
+#include <Tempest/WFile>
+#include <Tempest/Log>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+
+static const char     tag[]     = "OpenGothic/Pack";
+static const uint32_t ChunkSize = 256*1024;
+
+// LZ77 block codec, similar to lz4:
+//   token: 4 bit literal count | 4 bit (match length - MinMatch)
+//   [literal count ext] literals [uint16 offset] [match length ext]
+// last sequence contains literals only
+static const uint32_t MinMatch  = 4;
+static const uint32_t MaxOffset = 0xFFFF;
+static const uint32_t HashBits  = 14;
+
+static uint32_t hash4(const uint8_t* p) {
+  uint32_t v = 0;
+  std::memcpy(&v,p,4);
+  return (v*2654435761u) >> (32-HashBits);
+  }
+
+static void packLength(std::vector<uint8_t>& out, size_t len) {
+  for(; len>=255; len-=255)
+    out.push_back(255);
+  out.push_back(uint8_t(len));
+  }
+
+static void packSequence(std::vector<uint8_t>& out, const uint8_t* lit, size_t litLen, size_t offset, size_t matchLen) {
+  const size_t m   = matchLen>0 ? matchLen-MinMatch : 0;
+  uint8_t      tok = uint8_t((std::min<size_t>(litLen,15)<<4) | std::min<size_t>(m,15));
+  out.push_back(tok);
+  if(litLen>=15)
+    packLength(out,litLen-15);
+  out.insert(out.end(),lit,lit+litLen);
+  if(matchLen==0)
+    return;
+  out.push_back(uint8_t(offset));
+  out.push_back(uint8_t(offset>>8));
+  if(m>=15)
+    packLength(out,m-15);
+  }
+
+static void pack(const uint8_t* src, size_t n, std::vector<uint8_t>& out) {
+  std::vector<uint32_t> table(size_t(1)<<HashBits, uint32_t(-1));
+  out.clear();
+  out.reserve(n);
+
+  size_t anchor = 0, i = 0;
+  while(i+MinMatch<=n) {
+    uint32_t& slot = table[hash4(src+i)];
+    size_t    cand = slot;
+    slot = uint32_t(i);
+    if(cand==uint32_t(-1) || i-cand>MaxOffset || std::memcmp(src+cand,src+i,MinMatch)!=0) {
+      // skip faster over incompressible data
+      i += 1 + ((i-anchor)>>6);
+      continue;
+      }
+    size_t len = MinMatch;
+    while(i+len<n && src[cand+len]==src[i+len])
+      ++len;
+    packSequence(out,src+anchor,i-anchor,i-cand,len);
+    i     += len;
+    anchor = i;
+    }
+  packSequence(out,src+anchor,n-anchor,0,0);
+  }
+
+static size_t unpackLength(const uint8_t*& in, const uint8_t* end) {
+  size_t len = 0;
+  while(true) {
+    if(in==end)
+      throw std::runtime_error("invalid save-game file");
+    uint8_t b = *in++;
+    len += b;
+    if(b!=255)
+      return len;
+    }
+  }
+
+static void unpack(const uint8_t* in, size_t n, uint8_t* out, size_t outSize) {
+  const uint8_t* end = in+n;
+  size_t         at  = 0;
+  while(in<end) {
+    uint8_t tok    = *in++;
+    size_t  litLen = tok>>4;
+    if(litLen==15)
+      litLen += unpackLength(in,end);
+    if(size_t(end-in)<litLen || outSize-at<litLen)
+      throw std::runtime_error("invalid save-game file");
+    std::memcpy(out+at,in,litLen);
+    in += litLen;
+    at += litLen;
+    if(in==end)
+      break;
+
+    if(end-in<2)
+      throw std::runtime_error("invalid save-game file");
+    size_t offset = size_t(in[0]) | (size_t(in[1])<<8);
+    in += 2;
+    size_t len = tok&0xF;
+    if(len==15)
+      len += unpackLength(in,end);
+    len += MinMatch;
+    if(offset==0 || offset>at || outSize-at<len)
+      throw std::runtime_error("invalid save-game file");
+    // overlapping copy
+    const uint8_t* m = out+at-offset;
+    for(size_t i=0; i<len; ++i)
+      out[at+i] = m[i];
+    at += len;
+    }
+  if(at!=outSize)
+    throw std::runtime_error("invalid save-game file");
+  }
+
+static const std::string& flushedPath(const std::string& path) {
+  // file may be still in write queue
+  SaveWriter::flush();
+  return path;
+  }
+
+SaveReader::SaveReader(const std::string& path)
+  :fin(flushedPath(path)) {
+  char buf[sizeof(tag)] = {};
+  size_t sz = fin.read(buf,sizeof(buf));
+  if(sz!=sizeof(buf) || std::memcmp(buf,tag,sizeof(tag))!=0) {
+    fin.unget(sz);
+    return;
+    }
+
+  if(fin.read(&chunkSize,4)!=4 || fin.read(&rawSize,8)!=8 || chunkSize==0)
+    throw std::runtime_error("invalid save-game file");
+  packed  = true;
+  filePos = sizeof(tag)+4+8;
+  chunkAt.push_back(filePos);
+  chunkId = size_t(-1);
+  }
+
+size_t SaveReader::read(void* to, size_t sz) {
+  if(!packed)
+    return fin.read(to,sz);
+
+  auto   dest = reinterpret_cast<uint8_t*>(to);
+  size_t ret  = 0;
+  while(ret<sz && fetch(pos)) {
+    size_t off = size_t(pos-chunkBase);
+    size_t cnt = std::min(sz-ret, chunk.size()-off);
+    std::memcpy(dest+ret,chunk.data()+off,cnt);
+    ret += cnt;
+    pos += cnt;
+    }
+  return ret;
+  }
+
+size_t SaveReader::size() const {
+  if(!packed)
+    return fin.size();
+  return size_t(rawSize);
+  }
+
+uint8_t SaveReader::peek() {
+  if(!packed)
+    return fin.peek();
+  if(!fetch(pos))
+    return 0;
+  return chunk[size_t(pos-chunkBase)];
+  }
+
+size_t SaveReader::seek(size_t advance) {
+  if(!packed)
+    return fin.seek(advance);
+  advance = size_t(std::min<uint64_t>(advance,rawSize-pos));
+  pos    += advance;
+  return advance;
+  }
+
+size_t SaveReader::unget(size_t advance) {
+  if(!packed)
+    return fin.unget(advance);
+  advance = size_t(std::min<uint64_t>(advance,pos));
+  pos    -= advance;
+  return advance;
+  }
+
+bool SaveReader::fetch(uint64_t at) {
+  if(at>=rawSize)
+    return false;
+  size_t id = size_t(at/chunkSize);
+  if(id!=chunkId)
+    decodeChunk(id);
+  return true;
+  }
+
+void SaveReader::decodeChunk(size_t id) {
+  uint32_t hdr[2] = {};
+  // walk over chunk headers, if we need to skip forward
+  while(chunkAt.size()<=id) {
+    fileSeek(chunkAt.back());
+    if(fin.read(hdr,sizeof(hdr))!=sizeof(hdr))
+      throw std::runtime_error("invalid save-game file");
+    filePos += sizeof(hdr);
+    chunkAt.push_back(filePos+hdr[1]);
+    }
+
+  fileSeek(chunkAt[id]);
+  if(fin.read(hdr,sizeof(hdr))!=sizeof(hdr))
+    throw std::runtime_error("invalid save-game file");
+  filePos += sizeof(hdr);
+
+  const uint32_t rawSz    = hdr[0];
+  const uint32_t packedSz = hdr[1];
+  const uint64_t expect   = std::min<uint64_t>(chunkSize, rawSize-uint64_t(id)*chunkSize);
+  if(rawSz!=expect || packedSz>rawSz)
+    throw std::runtime_error("invalid save-game file");
+
+  chunk.resize(rawSz);
+  if(packedSz==rawSz) {
+    if(fin.read(chunk.data(),rawSz)!=rawSz)
+      throw std::runtime_error("invalid save-game file");
+    } else {
+    tmp.resize(packedSz);
+    if(fin.read(tmp.data(),packedSz)!=packedSz)
+      throw std::runtime_error("invalid save-game file");
+    unpack(tmp.data(),tmp.size(),chunk.data(),chunk.size());
+    }
+  filePos  += packedSz;
+  chunkId   = id;
+  chunkBase = uint64_t(id)*chunkSize;
+  }
+
+void SaveReader::fileSeek(size_t at) {
+  if(at<filePos)
+    fin.unget(filePos-at); else
+    fin.seek(at-filePos);
+  filePos = at;
+  }
+
+
+SaveWriter::SaveWriter() {
+  th = std::thread([this]() noexcept {
+    threadFunc();
+    });
+  }
+
+SaveWriter::~SaveWriter() {
+  {
+    std::lock_guard<std::mutex> guard(sync);
+    running = false;
+  }
+  cv.notify_all();
+  th.join();
+  }
+
+SaveWriter& SaveWriter::inst() {
+  static SaveWriter w;
+  return w;
+  }
+
+void SaveWriter::write(std::string path, std::vector<uint8_t>&& data) {
+  auto& w = inst();
+  {
+    std::lock_guard<std::mutex> guard(w.sync);
+    w.jobs.push_back(Job{std::move(path),std::move(data)});
+  }
+  w.cv.notify_all();
+  }
+
+void SaveWriter::flush() {
+  auto& w = inst();
+  std::unique_lock<std::mutex> lck(w.sync);
+  w.cv.wait(lck,[&w](){ return w.jobs.empty() && !w.busy; });
+  }
+
+void SaveWriter::threadFunc() {
+  while(true) {
+    Job job;
+    {
+      std::unique_lock<std::mutex> lck(sync);
+      cv.wait(lck,[this](){ return !jobs.empty() || !running; });
+      if(jobs.empty())
+        return;
+      job  = std::move(jobs.front());
+      jobs.pop_front();
+      busy = true;
+    }
+
+    try {
+      implWrite(job);
+      }
+    catch(std::system_error&) {
+      Tempest::Log::e("save error: unable to open file \"",job.path,"\"");
+      }
+    catch(std::runtime_error& e) {
+      Tempest::Log::e("save error: ",e.what());
+      }
+    catch(std::bad_alloc&) {
+      Tempest::Log::e("save error: out of memory");
+      }
+
+    {
+      std::lock_guard<std::mutex> guard(sync);
+      busy = false;
+    }
+    cv.notify_all();
+    }
+  }
+
+void SaveWriter::implWrite(const Job& job) {
+  // write into temporary file first, to not lose previous save on failure
+  const std::string tmpPath = job.path + ".tmp";
+  {
+    Tempest::WFile       fout(tmpPath);
+    std::vector<uint8_t> buf;
+    const uint32_t       chunkSz = ChunkSize;
+    const uint64_t       rawSz   = job.data.size();
+
+    auto wr = [&fout](const void* v, size_t sz) {
+      if(fout.write(v,sz)!=sz)
+        throw std::runtime_error("unable to write save-game file");
+      };
+    wr(tag,sizeof(tag));
+    wr(&chunkSz,4);
+    wr(&rawSz,8);
+
+    for(size_t i=0; i<job.data.size(); i+=ChunkSize) {
+      const uint8_t* src = job.data.data()+i;
+      const size_t   sz  = std::min<size_t>(ChunkSize,job.data.size()-i);
+      pack(src,sz,buf);
+
+      const bool     store  = buf.size()>=sz;
+      const uint32_t hdr[2] = {uint32_t(sz), store ? uint32_t(sz) : uint32_t(buf.size())};
+      wr(hdr,sizeof(hdr));
+      if(store)
+        wr(src,sz); else
+        wr(buf.data(),buf.size());
+      }
+    if(!fout.flush())
+      throw std::runtime_error("unable to write save-game file");
+  }
+
+  std::remove(job.path.c_str());
+  if(std::rename(tmpPath.c_str(),job.path.c_str())!=0)
+    throw std::runtime_error("unable to write save-game file");
+  }
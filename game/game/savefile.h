@@ -0,0 +1,75 @@
+#pragma once
+
+#include <Tempest/IDevice>
+#include <Tempest/RFile>
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Save-game container:
+//   tag | uint32 chunkSize | uint64 rawSize | chunk[]
+//   chunk: uint32 rawSize | uint32 packedSize | data (stored as-is, if packedSize==rawSize)
+// Files without container tag are read as-is (old uncompressed saves)
+class SaveReader final : public Tempest::IDevice {
+  public:
+    explicit SaveReader(const std::string& path);
+
+    size_t  read(void* to, size_t sz) override;
+    size_t  size() const override;
+    uint8_t peek() override;
+    size_t  seek(size_t advance) override;
+    size_t  unget(size_t advance) override;
+
+  private:
+    Tempest::RFile        fin;
+    bool                  packed    = false;
+    uint64_t              rawSize   = 0;
+    uint32_t              chunkSize = 0;
+
+    // file offsets of visited chunks
+    std::vector<size_t>   chunkAt;
+    size_t                filePos   = 0;
+
+    std::vector<uint8_t>  chunk, tmp;
+    size_t                chunkId   = 0;
+    uint64_t              chunkBase = 0;
+    uint64_t              pos       = 0;
+
+    bool                  fetch(uint64_t at);
+    void                  decodeChunk(size_t id);
+    void                  fileSeek(size_t at);
+  };
+
+// Background writer: compresses and writes snapshots of save-games, so game thread
+// only pays for in-memory serialization
+class SaveWriter final {
+  public:
+    static void write(std::string path, std::vector<uint8_t>&& data);
+    // blocks until all pending saves are on disk
+    static void flush();
+
+  private:
+    SaveWriter();
+    ~SaveWriter();
+
+    struct Job {
+      std::string          path;
+      std::vector<uint8_t> data;
+      };
+
+    static SaveWriter&      inst();
+    void                    threadFunc();
+    static void             implWrite(const Job& job);
+
+    std::mutex              sync;
+    std::condition_variable cv;
+    std::deque<Job>         jobs;
+    bool                    busy    = false;
+    bool                    running = true;
+    std::thread             th;
+  };
@@ -1,6 +1,7 @@
 #include "serialize.h"
 
 #include <cstring>
+#include <Tempest/MemWriter>
 
 #include "savegameheader.h"
 #include "world/world.h"
@@ -36,6 +37,61 @@ Serialize::Serialize()
   :ver(Version){
   }
 
+void Serialize::setContext(World* c) {
+  if(ctx!=c)
+    resetHandles();
+  ctx = c;
+  }
+
+void Serialize::resetHandles() {
+  wayPointId.clear();
+  wayPoints.clear();
+  npcHandle.clear();
+  mobsiHandle.clear();
+  }
+
+void Serialize::writeSection(const std::function<void()>& fn) {
+  std::vector<uint8_t> buf;
+  Tempest::MemWriter   wr{buf};
+  auto                 prevOut = out;
+  // waypoint table is local to section, so section can be skipped by reader
+  auto                 prevId  = std::move(wayPointId);
+  wayPointId.clear();
+
+  out = &wr;
+  fn();
+  out        = prevOut;
+  wayPointId = std::move(prevId);
+
+  implWrite(uint32_t(buf.size()));
+  writeBytes(buf.data(),buf.size());
+  }
+
+void Serialize::readSection(const std::function<void()>& fn) {
+  if(ver<35) {
+    fn();
+    return;
+    }
+  uint32_t sz=0;
+  implRead(sz);
+  const uint64_t end  = inPos+sz;
+  auto           prev = std::move(wayPoints);
+  wayPoints.clear();
+
+  fn();
+  wayPoints = std::move(prev);
+  if(inPos>end)
+    throw std::runtime_error("invalid save-game section");
+  const size_t rest = size_t(end-inPos);
+  if(in->seek(rest)!=rest)
+    throw std::runtime_error("unable to read save-game file");
+  inPos = end;
+  }
+
+void Serialize::skipSection() {
+  readSection([](){});
+  }
+
 void Serialize::implWrite(const std::string &s) {
   uint32_t sz=uint32_t(s.size());
   implWrite(sz);
@@ -85,12 +141,36 @@ void Serialize::implRead(Tempest::Pixmap &p) {
   }
 
 void Serialize::implWrite(const WayPoint *wptr) {
-  implWrite(wptr ? wptr->name : "");
+  if(wptr==nullptr) {
+    implWrite(uint32_t(-1));
+    return;
+    }
+  auto ins = wayPointId.emplace(wptr,uint32_t(wayPointId.size()));
+  implWrite(ins.first->second);
+  if(ins.second)
+    implWrite(wptr->name);
   }
 
 void Serialize::implRead(const WayPoint *&wptr) {
-  implRead(tmpStr);
-  wptr = ctx->findPoint(tmpStr,false);
+  if(ver<35) {
+    implRead(tmpStr);
+    wptr = ctx->findPoint(tmpStr,false);
+    return;
+    }
+
+  uint32_t id = uint32_t(-1);
+  implRead(id);
+  if(id==uint32_t(-1)) {
+    wptr = nullptr;
+    return;
+    }
+  if(id==wayPoints.size()) {
+    implRead(tmpStr);
+    wayPoints.push_back(ctx->findPoint(tmpStr,false));
+    }
+  if(id>=wayPoints.size())
+    throw std::runtime_error("invalid waypoint reference in save-game file");
+  wptr = wayPoints[id];
   }
 
 void Serialize::implWrite(const ScriptFn& fn) {
@@ -109,8 +189,7 @@ void Serialize::implRead(ScriptFn& fn) {
   }
 
 void Serialize::implWrite(const Npc* npc) {
-  uint32_t id = ctx->npcId(npc);
-  implWrite(id);
+  implWrite(npcIdOf(npc));
   }
 
 void Serialize::implRead(const Npc *&npc) {
@@ -120,8 +199,7 @@ void Serialize::implRead(const Npc *&npc) {
   }
 
 void Serialize::implWrite(Npc *npc) {
-  uint32_t id = ctx->npcId(npc);
-  implWrite(id);
+  implWrite(npcIdOf(npc));
   }
 
 void Serialize::implRead(Npc *&npc) {
@@ -131,8 +209,7 @@ void Serialize::implRead(Npc *&npc) {
   }
 
 void Serialize::implWrite(Interactive* mobsi) {
-  uint32_t id = ctx->mobsiId(mobsi);
-  implWrite(id);
+  implWrite(mobsiIdOf(mobsi));
   }
 
 void Serialize::implRead(Interactive*& mobsi) {
@@ -141,6 +218,47 @@ void Serialize::implRead(Interactive*& mobsi) {
   mobsi = ctx->mobsiById(id);
   }
 
+uint32_t Serialize::npcIdOf(const Npc* npc) {
+  if(npc==nullptr)
+    return uint32_t(-1);
+  if(npcHandle.empty()) {
+    for(uint32_t i=0; ; ++i) {
+      auto n = ctx->npcById(i);
+      if(n==nullptr)
+        break;
+      npcHandle[n] = i;
+      }
+    }
+  auto it = npcHandle.find(npc);
+  if(it==npcHandle.end())
+    return ctx->npcId(npc);
+  if(ctx->npcById(it->second)==npc)
+    return it->second;
+  // npc list was changed since table was built
+  npcHandle.clear();
+  return ctx->npcId(npc);
+  }
+
+uint32_t Serialize::mobsiIdOf(const Interactive* mobsi) {
+  if(mobsi==nullptr)
+    return uint32_t(-1);
+  if(mobsiHandle.empty()) {
+    for(uint32_t i=0; ; ++i) {
+      auto m = ctx->mobsiById(i);
+      if(m==nullptr)
+        break;
+      mobsiHandle[m] = i;
+      }
+    }
+  auto it = mobsiHandle.find(mobsi);
+  if(it==mobsiHandle.end())
+    return ctx->mobsiId(mobsi);
+  if(ctx->mobsiById(it->second)==mobsi)
+    return it->second;
+  mobsiHandle.clear();
+  return ctx->mobsiId(mobsi);
+  }
+
 void Serialize::implWrite(WeaponState w) {
   implWrite(uint8_t(w));
   }
@@ -7,8 +7,11 @@
 #include <Tempest/Point>
 
 #include <stdexcept>
+#include <cstring>
 #include <vector>
 #include <array>
+#include <functional>
+#include <unordered_map>
 #include <type_traits>
 
 #include <daedalus/DATFile.h>
@@ -35,7 +38,7 @@ class Serialize final {
   public:
     enum {
       MinVersion = 0,
-      Version    = 34
+      Version    = 35
       };
 
     Serialize(Tempest::ODevice& fout);
@@ -45,7 +48,12 @@ class Serialize final {
     static Serialize empty();
 
     uint16_t version() const { return ver; }
-    void setContext(World* ctx) { this->ctx=ctx; }
+    void setContext(World* ctx);
+
+    // length-prefixed block; reader may skip it, or leave it partially read
+    void writeSection(const std::function<void()>& fn);
+    void readSection (const std::function<void()>& fn);
+    void skipSection ();
 
     template<class T>
     T read(){ T t; read(t); return t; }
@@ -162,19 +170,20 @@ class Serialize final {
     void implWrite(const std::vector<bool>& s) {
       uint32_t sz=uint32_t(s.size());
       write(sz);
+      tmpBuf.resize(sz);
       for(size_t i=0; i<s.size(); ++i)
-        write(s[i]);
+        tmpBuf[i] = s[i] ? 1 : 0;
+      writeBytes(tmpBuf.data(),sz);
       }
 
     void implRead (std::vector<bool>& s) {
       uint32_t sz=0;
       read(sz);
+      tmpBuf.resize(sz);
+      readBytes(tmpBuf.data(),sz);
       s.resize(sz);
-      for(size_t i=0; i<s.size(); ++i) {
-        bool b=false;
-        read(b);
-        s[i] = b;
-        }
+      for(size_t i=0; i<s.size(); ++i)
+        s[i] = (tmpBuf[i]!=0);
       }
 
     template<size_t sz>
@@ -196,22 +205,22 @@ class Serialize final {
     void implRead (uint8_t (&s)[sz]) { readBytes(s,sz); }
 
     template<size_t sz>
-    void implWrite(const int32_t (&s)[sz]) { writeArr(s); }
+    void implWrite(const int32_t (&s)[sz]) { writeBytes(s,sizeof(s)); }
 
     template<size_t sz>
-    void implRead (int32_t (&s)[sz]) { readArr(s); }
+    void implRead (int32_t (&s)[sz]) { readBytes(s,sizeof(s)); }
 
     template<size_t sz>
-    void implWrite(const uint32_t (&s)[sz]) { writeArr(s); }
+    void implWrite(const uint32_t (&s)[sz]) { writeBytes(s,sizeof(s)); }
 
     template<size_t sz>
-    void implRead (uint32_t (&s)[sz]) { readArr(s); }
+    void implRead (uint32_t (&s)[sz]) { readBytes(s,sizeof(s)); }
 
     template<size_t sz>
-    void implWrite(const float (&s)[sz]) { writeArr(s); }
+    void implWrite(const float (&s)[sz]) { writeBytes(s,sizeof(s)); }
 
     template<size_t sz>
-    void implRead (float (&s)[sz]) { readArr(s); }
+    void implRead (float (&s)[sz]) { readBytes(s,sizeof(s)); }
 
     void implWrite(const Tempest::Vec3& s) { writeBytes(&s,sizeof(s)); }
     void implRead (Tempest::Vec3& s)       { readBytes (&s,sizeof(s)); }
@@ -229,10 +238,10 @@ class Serialize final {
     void implWrite(const Daedalus::GEngineClasses::C_Npc& h);
     void implRead (Daedalus::GEngineClasses::C_Npc&       h);
 
-    void implWrite(const Daedalus::DataContainer<int>&               c) { implWriteDat<int>  (c); }
-    void implRead (Daedalus::DataContainer<int>&                     c) { implReadDat <int>  (c); }
-    void implWrite(const Daedalus::DataContainer<float>&             c) { implWriteDat<float>(c); }
-    void implRead (Daedalus::DataContainer<float>&                   c) { implReadDat <float>(c); }
+    void implWrite(const Daedalus::DataContainer<int>&               c) { implWriteDatPod<int>  (c); }
+    void implRead (Daedalus::DataContainer<int>&                     c) { implReadDatPod <int>  (c); }
+    void implWrite(const Daedalus::DataContainer<float>&             c) { implWriteDatPod<float>(c); }
+    void implRead (Daedalus::DataContainer<float>&                   c) { implReadDatPod <float>(c); }
     void implWrite(const Daedalus::DataContainer<Daedalus::ZString>& c) { implWriteDat<Daedalus::ZString>(c); }
     void implRead (Daedalus::DataContainer<Daedalus::ZString>&       c) { implReadDat <Daedalus::ZString>(c); }
 
@@ -255,6 +264,28 @@ class Serialize final {
         read(s[i]);
       }
 
+    // same layout as implWriteDat, but single write for whole container
+    template<class T>
+    void implWriteDatPod(const Daedalus::DataContainer<T>& s) {
+      uint32_t sz=uint32_t(s.size());
+      write(sz);
+      tmpBuf.resize(sz*sizeof(T));
+      for(size_t i=0; i<sz; ++i)
+        std::memcpy(&tmpBuf[i*sizeof(T)],&s[i],sizeof(T));
+      writeBytes(tmpBuf.data(),tmpBuf.size());
+      }
+
+    template<class T>
+    void implReadDatPod(Daedalus::DataContainer<T>& s) {
+      uint32_t sz=0;
+      read(sz);
+      tmpBuf.resize(sz*sizeof(T));
+      readBytes(tmpBuf.data(),tmpBuf.size());
+      s.resize(sz);
+      for(size_t i=0; i<sz; ++i)
+        std::memcpy(&s[i],&tmpBuf[i*sizeof(T)],sizeof(T));
+      }
+
     template<class T>
     void implWriteVec(const std::vector<T>& s,std::false_type) {
       uint32_t sz=uint32_t(s.size());
@@ -290,6 +321,7 @@ class Serialize final {
     void readBytes(void* v,size_t sz) {
       if(in->read(v,sz)!=sz)
         throw std::runtime_error("unable to read save-game file");
+      inPos += sz;
       }
 
     void writeBytes(const void* v,size_t sz) {
@@ -307,10 +339,22 @@ class Serialize final {
       for(size_t i=0;i<sz;++i) read(s[i]);
       }
 
-    static const char tag[];
-    Tempest::ODevice* out=nullptr;
-    Tempest::IDevice* in =nullptr;
-    uint16_t          ver=Version;
-    World*            ctx=nullptr;
-    std::string       tmpStr;
+    void     resetHandles();
+    uint32_t npcIdOf  (const Npc* npc);
+    uint32_t mobsiIdOf(const Interactive* mobsi);
+
+    static const char                            tag[];
+    Tempest::ODevice*                            out=nullptr;
+    Tempest::IDevice*                            in =nullptr;
+    uint64_t                                     inPos=0;
+    uint16_t                                     ver=Version;
+    World*                                       ctx=nullptr;
+    std::string                                  tmpStr;
+    std::vector<uint8_t>                         tmpBuf;
+
+    // waypoint name is written once per section, later references are indices
+    std::unordered_map<const WayPoint*,uint32_t> wayPointId;
+    std::vector<const WayPoint*>                 wayPoints;
+    // pointer -> id, instead of linear search in World
+    std::unordered_map<const void*,uint32_t>     npcHandle, mobsiHandle;
   };
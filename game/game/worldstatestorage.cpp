@@ -12,14 +12,33 @@ WorldStateStorage::WorldStateStorage(World &w)
   Tempest::MemWriter wr{storage};
   Serialize          sr{wr};
   w.save(sr);
+  spill();
   }
 
 WorldStateStorage::WorldStateStorage(Serialize &fin)
   :wname(fin.read<std::string>()){
   fin.read(storage);
+  spill();
   }
 
 void WorldStateStorage::save(Serialize &fout) const {
   fout.write(wname);
-  fout.write(storage);
+  // same layout as std::vector<uint8_t>
+  fout.write(std::string_view(reinterpret_cast<const char*>(data()),size()));
+  }
+
+const uint8_t* WorldStateStorage::data() const {
+  return mapped.isEmpty() ? storage.data() : mapped.data();
+  }
+
+size_t WorldStateStorage::size() const {
+  return mapped.isEmpty() ? storage.size() : mapped.size();
+  }
+
+void WorldStateStorage::spill() {
+  mapped = MappedFile::spill(storage.data(),storage.size());
+  if(mapped.isEmpty())
+    return;
+  storage.clear();
+  storage.shrink_to_fit();
   }
@@ -7,6 +7,8 @@
 #include <cstdint>
 #include <memory>
 
+#include "utils/mappedfile.h"
+
 class World;
 class GameSession;
 class Serialize;
@@ -20,12 +22,19 @@ class WorldStateStorage final {
     WorldStateStorage(WorldStateStorage&&)=default;
     WorldStateStorage& operator = (WorldStateStorage&&)=default;
 
-    bool                 isEmpty() const { return storage.empty(); }
+    bool                 isEmpty() const { return size()==0; }
     const std::string&   name()    const { return wname; }
     void                 save(Serialize& fout) const;
 
-    std::vector<uint8_t> storage;
+    const uint8_t*       data()    const;
+    size_t               size()    const;
 
   private:
+    void                 spill();
+
     std::string          wname;
+    // state of visited world is kept in temporary file, and paged in on demand
+    MappedFile           mapped;
+    // fallback, if temporary file is not available
+    std::vector<uint8_t> storage;
   };
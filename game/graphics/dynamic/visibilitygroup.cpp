@@ -60,6 +60,12 @@ const Bounds& VisibilityGroup::Token::bounds() const {
   return owner->tokens[id].bbox;
   }
 
+bool VisibilityGroup::Token::isVisible() const {
+  if(owner==nullptr)
+    return false;
+  return owner->tokens[id].visible;
+  }
+
 VisibilityGroup::VisibilityGroup() {
   freeList.reserve(4);
   }
@@ -72,6 +78,7 @@ VisibilityGroup::Token VisibilityGroup::get() {
     } else {
     tokens.emplace_back();
     }
+  tokens[id].visible = true;
   // auto& t = tokens[id];
   // t.pos  = at;
   // t.bbox = bbox;
@@ -99,6 +106,7 @@ void VisibilityGroup::pass(const Frustrum f[]) {
       t.vSet->push(t.id,SceneGlobals::V_Shadow0);
       t.vSet->push(t.id,SceneGlobals::V_Shadow1);
       t.vSet->push(t.id,SceneGlobals::V_Main);
+      t.visible = true;
       } else {
       bool visible[SceneGlobals::V_Count] = {};
       visible[SceneGlobals::V_Shadow0] = f[SceneGlobals::V_Shadow0].testPoint(b.midTr, b.r);
@@ -116,6 +124,7 @@ void VisibilityGroup::pass(const Frustrum f[]) {
         t.vSet->push(t.id,SceneGlobals::V_Shadow1);
       if(visible[SceneGlobals::V_Main])
         t.vSet->push(t.id,SceneGlobals::V_Main);
+      t.visible = visible[SceneGlobals::V_Shadow0] || visible[SceneGlobals::V_Shadow1] || visible[SceneGlobals::V_Main];
       }
 
     });
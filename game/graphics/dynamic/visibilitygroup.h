@@ -26,6 +26,7 @@ class VisibilityGroup {
         void   setBounds   (const Bounds& bbox);
 
         const Bounds& bounds() const;
+        bool          isVisible() const;
 
       private:
         Token(VisibilityGroup& ow, size_t id);
@@ -46,6 +47,7 @@ class VisibilityGroup {
       size_t             id     = 0;
       bool               updateBbox = false;
       bool               alwaysVis = false;
+      bool               visible   = true; // result of last pass, in any camera
       };
 
     std::vector<Tok>    tokens;
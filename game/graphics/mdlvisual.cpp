@@ -464,7 +464,7 @@ void MdlVisual::setTorch(bool t, World& owner) {
   torch.boneId = (skeleton==nullptr ? size_t(-1) : skeleton->findNode("ZS_LEFTHAND"));
   }
 
-bool MdlVisual::updateAnimation(Npc* npc, World& world) {
+bool MdlVisual::updateAnimation(Npc* npc, World& world, Pose::Lod lod) {
   Pose&    pose      = *skInst;
   uint64_t tickCount = world.tickCount();
   auto     pos3      = Vec3{pos.at(3,0), pos.at(3,1), pos.at(3,2)};
@@ -485,13 +485,21 @@ bool MdlVisual::updateAnimation(Npc* npc, World& world) {
     }
 
   solver.update(tickCount);
-  const bool changed = pose.update(tickCount);
+  if(lod==Pose::LodFrozen)
+    return false;
+  // player is never quantized to shared time-steps
+  PoseCache* cache   = (npc!=nullptr && npc==world.player()) ? nullptr : &world.poseCache();
+  const bool changed = pose.update(tickCount,lod,cache);
 
   if(changed)
     view.setPose(pos,pose);
   return changed;
   }
 
+bool MdlVisual::isVisible() const {
+  return view.isVisible();
+  }
+
 void MdlVisual::processLayers(World& world) {
   Pose&    pose      = *skInst;
   uint64_t tickCount = world.tickCount();
@@ -274,6 +274,8 @@ void Animation::setupIndex() {
   std::sort(sequences.begin(),sequences.end(),[](const Sequence& a,const Sequence& b){
     return a.name<b.name;
     });
+  for(auto& sq:sequences)
+    sq.nameId = StrId(sq.name);
 
   for(auto& s:sequences) {
     if(s.comb.size()==0)
@@ -313,12 +315,14 @@ Animation::Sequence::Sequence(const std::string &fname) {
   ZenLoad::ZenParser            zen(fname,idx);
   ZenLoad::ModelAnimationParser p(zen);
 
+  std::vector<ZenLoad::zCModelAniSample> samples;
   data = std::make_shared<AnimData>();
   while(true) {
     ZenLoad::ModelAnimationParser::EChunkType type = p.parse();
     switch(type) {
       case ZenLoad::ModelAnimationParser::CHUNK_EOF:{
-        setupMoveTr();
+        data->setupMoveTr(samples);
+        data->samples.pack(samples,data->nodeIndex.size());
         return;
         }
       case ZenLoad::ModelAnimationParser::CHUNK_HEADER: {
@@ -330,7 +334,7 @@ Animation::Sequence::Sequence(const std::string &fname) {
         }
       case ZenLoad::ModelAnimationParser::CHUNK_RAWDATA:
         data->nodeIndex = std::move(p.getNodeIndex());
-        data->samples   = p.getSamples();
+        samples         = p.getSamples();
         break;
       case ZenLoad::ModelAnimationParser::CHUNK_ERROR:
         throw std::runtime_error("animation load error");
@@ -654,11 +658,7 @@ void Animation::Sequence::schemeName(char scheme[]) const {
     }
   }
 
-void Animation::Sequence::setupMoveTr() {
-  data->setupMoveTr();
-  }
-
-void Animation::AnimData::setupMoveTr() {
+void Animation::AnimData::setupMoveTr(const std::vector<ZenLoad::zCModelAniSample>& samples) {
   size_t sz = nodeIndex.size();
 
   if(samples.size()>0 && samples.size()>=sz) {
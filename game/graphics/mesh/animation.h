@@ -4,6 +4,9 @@
 #include <Tempest/Vec>
 #include <memory>
 
+#include "utils/strid.h"
+#include "packedsamples.h"
+
 class Npc;
 class MdlVisual;
 class World;
@@ -49,7 +52,7 @@ class Animation final {
       Tempest::Vec3                               translate={};
       Tempest::Vec3                               moveTr={};
 
-      std::vector<ZenLoad::zCModelAniSample>      samples;
+      PackedSamples                               samples;
       std::vector<uint32_t>                       nodeIndex;
       std::vector<Tempest::Vec3>                  tr;
       bool                                        hasMoveTr=false;
@@ -71,7 +74,7 @@ class Animation final {
       std::vector<uint64_t>                       defParFrame;
       std::vector<uint64_t>                       defWindow;
 
-      void                                        setupMoveTr();
+      void                                        setupMoveTr(const std::vector<ZenLoad::zCModelAniSample>& samples);
       void                                        setupEvents(float fpsRate);
       };
 
@@ -101,6 +104,7 @@ class Animation final {
       void                                   schemeName(char buf[64]) const;
 
       std::string                            name, askName;
+      StrId                                  nameId;
       const char*                            shortName = nullptr;
       uint32_t                               layer  =0;
       Flags                                  flags  =Flags::None;
@@ -115,7 +119,6 @@ class Animation final {
       std::shared_ptr<AnimData>              data;
 
       private:
-        void                                 setupMoveTr();
         static void                          processEvent(const ZenLoad::zCModelEvent& e, EvCount& ev, uint64_t time);
         bool                                 extractFrames(uint64_t &frameA, uint64_t &frameB, bool &invert, uint64_t barrier, uint64_t sTime, uint64_t now) const;
       };
@@ -108,11 +108,17 @@ const Animation::Sequence* AnimationSolver::solveAnim(AnimationSolver::Anim a, W
   return implSolveAnim(a,st,wlkMode,pose);
   }
 
+bool AnimationSolver::isWounded(const Pose& pose) {
+  static const StrId s0("S_WOUNDED"), s1("S_WOUNDEDB"), t0("T_STAND_2_WOUNDED"), t1("T_STAND_2_WOUNDEDB");
+  return pose.isInAnim(s0) || pose.isInAnim(t0) || pose.isInAnim(s1) || pose.isInAnim(t1);
+  }
+
 const Animation::Sequence* AnimationSolver::implSolveAnim(AnimationSolver::Anim a, WeaponState st, WalkBit wlkMode, const Pose& pose) const {
+  static const StrId fistRun("S_FISTRUNL"), w1hRun("S_1HRUNL"), w2hRun("S_2HRUNL");
   // Atack
   if(st==WeaponState::Fist) {
     if(a==Anim::Atack) {
-      if(pose.isInAnim("S_FISTRUNL"))
+      if(pose.isInAnim(fistRun))
         return solveFrm("T_FISTATTACKMOVE");
       return solveFrm("S_FISTATTACK");
       }
@@ -120,7 +126,7 @@ const Animation::Sequence* AnimationSolver::implSolveAnim(AnimationSolver::Anim
       return solveFrm("T_FISTPARADE_0");
     }
   else if(st==WeaponState::W1H || st==WeaponState::W2H) {
-    if(a==Anim::Atack && (pose.isInAnim("S_1HRUNL") || pose.isInAnim("S_2HRUNL")))
+    if(a==Anim::Atack && (pose.isInAnim(w1hRun) || pose.isInAnim(w2hRun)))
       return solveFrm("T_%sATTACKMOVE",st);
     if(a==Anim::AtackL)
       return solveFrm("T_%sATTACKL",st);
@@ -288,8 +294,7 @@ const Animation::Sequence* AnimationSolver::implSolveAnim(AnimationSolver::Anim
   if(a==Anim::StumbleB)
     return solveFrm("T_STUMBLEB");
   if(a==Anim::DeadA) {
-    if(pose.isInAnim("S_WOUNDED")  || pose.isInAnim("T_STAND_2_WOUNDED") ||
-       pose.isInAnim("S_WOUNDEDB") || pose.isInAnim("T_STAND_2_WOUNDEDB"))
+    if(isWounded(pose))
       return solveDead("T_WOUNDED_2_DEAD","T_WOUNDEDB_2_DEADB");
     if(pose.bodyState()==BS_FALL)
       return solveDead("T_DEAD", "T_DEADB");
@@ -298,8 +303,7 @@ const Animation::Sequence* AnimationSolver::implSolveAnim(AnimationSolver::Anim
     return solveDead("S_DEAD", "S_DEADB");
     }
   if(a==Anim::DeadB) {
-    if(pose.isInAnim("S_WOUNDED")  || pose.isInAnim("T_STAND_2_WOUNDED") ||
-       pose.isInAnim("S_WOUNDEDB") || pose.isInAnim("T_STAND_2_WOUNDEDB"))
+    if(isWounded(pose))
       return solveDead("T_WOUNDEDB_2_DEADB","T_WOUNDED_2_DEAD");
     if(pose.hasAnim())
       return solveDead("T_DEADB","T_DEAD"); else
@@ -96,6 +96,7 @@ class AnimationSolver final {
     const Animation::Sequence*     solveDead   (std::string_view format1, std::string_view format2) const;
 
     const Animation::Sequence*     implSolveAnim(Anim a, WeaponState st, WalkBit wlk, const Pose &pose) const;
+    static bool                    isWounded(const Pose& pose);
     void                           invalidateCache();
 
     const Skeleton*                baseSk=nullptr;
@@ -2,6 +2,11 @@
 
 #include <cmath>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP>=2)
+#include <emmintrin.h>
+#define ANIMMATH_SSE2
+#endif
+
 static float mix(float x,float y,float a){
   return x+(y-x)*a;
   }
@@ -95,3 +100,28 @@ Tempest::Matrix4x4 mkMatrix(const ZenLoad::zCModelAniSample& s) {
   return mkMatrix(s.rotation.x,s.rotation.y,s.rotation.z,s.rotation.w,
                   s.position.x,s.position.y,s.position.z);
   }
+
+void mulMatrix(Tempest::Matrix4x4& r, const Tempest::Matrix4x4& a, const Tempest::Matrix4x4& b) {
+#if defined(ANIMMATH_SSE2)
+  // column-major: column 'i' of result is linear combination of columns of 'a'
+  const float* ma = reinterpret_cast<const float*>(&a);
+  const float* mb = reinterpret_cast<const float*>(&b);
+  float*       mr = reinterpret_cast<float*>(&r);
+  const __m128 a0 = _mm_loadu_ps(ma+0);
+  const __m128 a1 = _mm_loadu_ps(ma+4);
+  const __m128 a2 = _mm_loadu_ps(ma+8);
+  const __m128 a3 = _mm_loadu_ps(ma+12);
+  for(int i=0; i<4; ++i) {
+    const __m128 bi = _mm_loadu_ps(mb+i*4);
+    __m128 c = _mm_mul_ps(a0,_mm_shuffle_ps(bi,bi,_MM_SHUFFLE(0,0,0,0)));
+    c = _mm_add_ps(c,_mm_mul_ps(a1,_mm_shuffle_ps(bi,bi,_MM_SHUFFLE(1,1,1,1))));
+    c = _mm_add_ps(c,_mm_mul_ps(a2,_mm_shuffle_ps(bi,bi,_MM_SHUFFLE(2,2,2,2))));
+    c = _mm_add_ps(c,_mm_mul_ps(a3,_mm_shuffle_ps(bi,bi,_MM_SHUFFLE(3,3,3,3))));
+    _mm_storeu_ps(mr+i*4,c);
+    }
+#else
+  Tempest::Matrix4x4 m = a;
+  m.mul(b);
+  r = m;
+#endif
+  }
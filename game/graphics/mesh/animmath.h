@@ -6,3 +6,6 @@
 
 ZenLoad::zCModelAniSample mix(const ZenLoad::zCModelAniSample& x,const ZenLoad::zCModelAniSample& y,float a);
 Tempest::Matrix4x4        mkMatrix(const ZenLoad::zCModelAniSample& s);
+
+// r = a*b; r may alias a or b
+void                      mulMatrix(Tempest::Matrix4x4& r, const Tempest::Matrix4x4& a, const Tempest::Matrix4x4& b);
@@ -0,0 +1,406 @@
+#include "packedsamples.h"
+
+#include <cmath>
+#include <chrono>
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP>=2)
+#include <emmintrin.h>
+#define PACKEDSAMPLES_SSE2
+#endif
+
+#include "animmath.h"
+
+static constexpr uint32_t Animated   = 0x80000000;
+static constexpr float    RotConstEps = 0.999999f;
+static constexpr float    PosConstEps = 0.01f;
+static constexpr float    RotRange    = 0.70710678f; // 1/sqrt(2)
+static constexpr size_t   BlockSize   = 32;
+
+PackedSamples::RotKey PackedSamples::packRot(const ZMath::float4& src) {
+  float q[4] = {src.x,src.y,src.z,src.w};
+  float len  = std::sqrt(q[0]*q[0]+q[1]*q[1]+q[2]*q[2]+q[3]*q[3]);
+  if(len<=0.f) {
+    q[0] = 0; q[1] = 0; q[2] = 0; q[3] = 1;
+    len  = 1;
+    }
+
+  int largest = 0;
+  for(int i=1; i<4; ++i)
+    if(std::abs(q[i])>std::abs(q[largest]))
+      largest = i;
+  // q and -q are same rotation: keep largest component positive, so it can be restored from the other three
+  const float sign = (q[largest]<0 ? -1.f : 1.f)/len;
+
+  RotKey k;
+  for(int i=0, r=0; i<4; ++i) {
+    if(i==largest)
+      continue;
+    float v = std::clamp(q[i]*sign/RotRange,-1.f,1.f);
+    k.v[r] = uint16_t(std::lround((v*0.5f+0.5f)*32767.f));
+    ++r;
+    }
+  k.v[0] = uint16_t(k.v[0] | ((largest&1)<<15));
+  k.v[1] = uint16_t(k.v[1] | ((largest>>1)<<15));
+  return k;
+  }
+
+void PackedSamples::unpackRot(const RotKey& k, float& x, float& y, float& z, float& w) {
+  // destination of 3 stored components, for each position of largest component
+  static const uint8_t dst[4][3] = {{1,2,3},{0,2,3},{0,1,3},{0,1,2}};
+  const int largest = (k.v[0]>>15) | ((k.v[1]>>15)<<1);
+  const float a = float(k.v[0]&0x7FFF)*(2.f*RotRange/32767.f) - RotRange;
+  const float b = float(k.v[1]&0x7FFF)*(2.f*RotRange/32767.f) - RotRange;
+  const float c = float(k.v[2]&0x7FFF)*(2.f*RotRange/32767.f) - RotRange;
+
+  float q[4];
+  q[largest]          = std::sqrt(std::max(0.f,1.f-a*a-b*b-c*c));
+  q[dst[largest][0]]  = a;
+  q[dst[largest][1]]  = b;
+  q[dst[largest][2]]  = c;
+  x = q[0];
+  y = q[1];
+  z = q[2];
+  w = q[3];
+  }
+
+void PackedSamples::pack(const std::vector<ZenLoad::zCModelAniSample>& samples, size_t tracks) {
+  *this = PackedSamples();
+  if(tracks==0 || samples.size()<tracks)
+    return;
+
+  numTracks = uint32_t(tracks);
+  numFrames = uint32_t(samples.size()/tracks);
+  rotTrack.resize(numTracks);
+  posTrack.resize(numTracks);
+
+  for(uint32_t t=0; t<numTracks; ++t) {
+    auto& q0 = samples[t].rotation;
+    auto& p0 = samples[t].position;
+    bool  constRot = true, constPos = true;
+    for(uint32_t f=1; f<numFrames; ++f) {
+      auto& s   = samples[f*numTracks+t];
+      float dot = q0.x*s.rotation.x + q0.y*s.rotation.y + q0.z*s.rotation.z + q0.w*s.rotation.w;
+      if(std::abs(dot)<RotConstEps)
+        constRot = false;
+      if(std::abs(s.position.x-p0.x)>PosConstEps ||
+         std::abs(s.position.y-p0.y)>PosConstEps ||
+         std::abs(s.position.z-p0.z)>PosConstEps)
+        constPos = false;
+      }
+
+    if(constRot) {
+      rotTrack[t] = uint32_t(rotConst.size());
+      rotConst.push_back(q0);
+      } else {
+      rotTrack[t] = uint32_t(rotAnim.size()) | Animated;
+      rotAnim.push_back(t);
+      }
+
+    if(constPos) {
+      posTrack[t] = uint32_t(posConst.size());
+      posConst.push_back(p0);
+      } else {
+      posTrack[t] = uint32_t(posAnim.size()) | Animated;
+      posAnim.push_back(t);
+      }
+    }
+
+  posRange.resize(posAnim.size());
+  for(size_t i=0; i<posAnim.size(); ++i) {
+    Tempest::Vec3 mn = {samples[posAnim[i]].position.x, samples[posAnim[i]].position.y, samples[posAnim[i]].position.z};
+    Tempest::Vec3 mx = mn;
+    for(uint32_t f=1; f<numFrames; ++f) {
+      auto& p = samples[f*numTracks+posAnim[i]].position;
+      mn.x = std::min(mn.x,p.x); mx.x = std::max(mx.x,p.x);
+      mn.y = std::min(mn.y,p.y); mx.y = std::max(mx.y,p.y);
+      mn.z = std::min(mn.z,p.z); mx.z = std::max(mx.z,p.z);
+      }
+    posRange[i].min   = mn;
+    posRange[i].scale = Tempest::Vec3((mx.x-mn.x)/65535.f, (mx.y-mn.y)/65535.f, (mx.z-mn.z)/65535.f);
+    }
+
+  rotKeys.resize(size_t(numFrames)*rotAnim.size());
+  posKeys.resize(size_t(numFrames)*posAnim.size());
+  for(uint32_t f=0; f<numFrames; ++f) {
+    auto* smp = &samples[f*numTracks];
+    for(size_t i=0; i<rotAnim.size(); ++i)
+      rotKeys[f*rotAnim.size()+i] = packRot(smp[rotAnim[i]].rotation);
+    for(size_t i=0; i<posAnim.size(); ++i) {
+      auto& p  = smp[posAnim[i]].position;
+      auto& r  = posRange[i];
+      auto& k  = posKeys[f*posAnim.size()+i];
+      float v[3] = {p.x-r.min.x, p.y-r.min.y, p.z-r.min.z};
+      float s[3] = {r.scale.x, r.scale.y, r.scale.z};
+      for(int c=0; c<3; ++c)
+        k.v[c] = s[c]>0.f ? uint16_t(std::clamp<long>(std::lround(v[c]/s[c]),0,65535)) : 0;
+      }
+    }
+  }
+
+size_t PackedSamples::memoryUsage() const {
+  return rotTrack.size()*sizeof(uint32_t) + posTrack.size()*sizeof(uint32_t) +
+         rotConst.size()*sizeof(ZMath::float4) + posConst.size()*sizeof(ZMath::float3) +
+         rotAnim.size()*sizeof(uint32_t) + posAnim.size()*sizeof(uint32_t) +
+         rotKeys.size()*sizeof(RotKey) + posKeys.size()*sizeof(PosKey) + posRange.size()*sizeof(PosRange);
+  }
+
+void PackedSamples::decode(uint32_t frameA, uint32_t frameB, float a,
+                           const uint32_t* nodeIndex, Tempest::Matrix4x4* out, size_t outSize,
+                           const uint8_t* skip) const {
+  if(isEmpty())
+    return;
+  frameA = std::min(frameA,numFrames-1);
+  frameB = std::min(frameB,numFrames-1);
+
+  const RotKey* rotA = rotKeys.data() + size_t(frameA)*rotAnim.size();
+  const RotKey* rotB = rotKeys.data() + size_t(frameB)*rotAnim.size();
+  const PosKey* posA = posKeys.data() + size_t(frameA)*posAnim.size();
+  const PosKey* posB = posKeys.data() + size_t(frameB)*posAnim.size();
+
+  // SoA scratch: 4 quaternion + 3 position components, for both frames
+  alignas(16) float qa[4][BlockSize], qb[4][BlockSize];
+  alignas(16) float pa[3][BlockSize], pb[3][BlockSize];
+
+  uint32_t trk[BlockSize];
+  for(uint32_t next=0; next<numTracks;) {
+    // gather next block of tracks, that have to be written
+    size_t cnt = 0;
+    for(; next<numTracks && cnt<BlockSize; ++next) {
+      const uint32_t idx = nodeIndex[next];
+      if(idx>=outSize || (skip!=nullptr && skip[idx]))
+        continue;
+      trk[cnt] = next;
+      ++cnt;
+      }
+
+    for(size_t i=0; i<cnt; ++i) {
+      const uint32_t rt = rotTrack[trk[i]];
+      if(rt&Animated) {
+        unpackRot(rotA[rt&~Animated],qa[0][i],qa[1][i],qa[2][i],qa[3][i]);
+        unpackRot(rotB[rt&~Animated],qb[0][i],qb[1][i],qb[2][i],qb[3][i]);
+        } else {
+        auto& q = rotConst[rt];
+        qa[0][i] = qb[0][i] = q.x;
+        qa[1][i] = qb[1][i] = q.y;
+        qa[2][i] = qb[2][i] = q.z;
+        qa[3][i] = qb[3][i] = q.w;
+        }
+
+      const uint32_t pt = posTrack[trk[i]];
+      if(pt&Animated) {
+        auto& r  = posRange[pt&~Animated];
+        auto& ka = posA[pt&~Animated];
+        auto& kb = posB[pt&~Animated];
+        pa[0][i] = r.min.x + float(ka.v[0])*r.scale.x;
+        pa[1][i] = r.min.y + float(ka.v[1])*r.scale.y;
+        pa[2][i] = r.min.z + float(ka.v[2])*r.scale.z;
+        pb[0][i] = r.min.x + float(kb.v[0])*r.scale.x;
+        pb[1][i] = r.min.y + float(kb.v[1])*r.scale.y;
+        pb[2][i] = r.min.z + float(kb.v[2])*r.scale.z;
+        } else {
+        auto& p = posConst[pt];
+        pa[0][i] = pb[0][i] = p.x;
+        pa[1][i] = pb[1][i] = p.y;
+        pa[2][i] = pb[2][i] = p.z;
+        }
+      }
+    // pad last lanes with identity
+    for(size_t i=cnt; i<((cnt+3)&~size_t(3)); ++i) {
+      for(int c=0; c<4; ++c)
+        qa[c][i] = qb[c][i] = (c==3 ? 1.f : 0.f);
+      for(int c=0; c<3; ++c)
+        pa[c][i] = pb[c][i] = 0.f;
+      }
+
+    size_t i = 0;
+#if defined(PACKEDSAMPLES_SSE2)
+    const __m128 ta   = _mm_set1_ps(a);
+    const __m128 ta1  = _mm_set1_ps(1.f-a);
+    const __m128 one  = _mm_set1_ps(1.f);
+    const __m128 two  = _mm_set1_ps(2.f);
+    const __m128 lerp = _mm_set1_ps(0.95f);
+    const __m128 sgn  = _mm_set1_ps(-0.f);
+    for(; i<cnt; i+=4) {
+      __m128 ax = _mm_load_ps(qa[0]+i), ay = _mm_load_ps(qa[1]+i), az = _mm_load_ps(qa[2]+i), aw = _mm_load_ps(qa[3]+i);
+      __m128 bx = _mm_load_ps(qb[0]+i), by = _mm_load_ps(qb[1]+i), bz = _mm_load_ps(qb[2]+i), bw = _mm_load_ps(qb[3]+i);
+
+      // shortest path: flip second quaternion, if dot is negative
+      __m128 dot  = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ax,bx),_mm_mul_ps(ay,by)),_mm_add_ps(_mm_mul_ps(az,bz),_mm_mul_ps(aw,bw)));
+      __m128 flip = _mm_and_ps(dot,sgn);
+      bx  = _mm_xor_ps(bx,flip);
+      by  = _mm_xor_ps(by,flip);
+      bz  = _mm_xor_ps(bz,flip);
+      bw  = _mm_xor_ps(bw,flip);
+      dot = _mm_xor_ps(dot,flip);
+
+      __m128 x = _mm_add_ps(_mm_mul_ps(ax,ta1),_mm_mul_ps(bx,ta));
+      __m128 y = _mm_add_ps(_mm_mul_ps(ay,ta1),_mm_mul_ps(by,ta));
+      __m128 z = _mm_add_ps(_mm_mul_ps(az,ta1),_mm_mul_ps(bz,ta));
+      __m128 w = _mm_add_ps(_mm_mul_ps(aw,ta1),_mm_mul_ps(bw,ta));
+      __m128 l = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x,x),_mm_mul_ps(y,y)),_mm_add_ps(_mm_mul_ps(z,z),_mm_mul_ps(w,w))));
+      __m128 il = _mm_div_ps(one,l);
+      x = _mm_mul_ps(x,il);
+      y = _mm_mul_ps(y,il);
+      z = _mm_mul_ps(z,il);
+      w = _mm_mul_ps(w,il);
+
+      // large angle between keys: fallback to exact slerp
+      int slow = _mm_movemask_ps(_mm_cmplt_ps(dot,lerp));
+      if(slow!=0) {
+        alignas(16) float q[4][4];
+        _mm_store_ps(q[0],x);
+        _mm_store_ps(q[1],y);
+        _mm_store_ps(q[2],z);
+        _mm_store_ps(q[3],w);
+        for(int b=0; b<4; ++b) {
+          if((slow&(1<<b))==0)
+            continue;
+          ZenLoad::zCModelAniSample sa, sb;
+          sa.rotation = ZMath::float4{qa[0][i+b],qa[1][i+b],qa[2][i+b],qa[3][i+b]};
+          sb.rotation = ZMath::float4{qb[0][i+b],qb[1][i+b],qb[2][i+b],qb[3][i+b]};
+          auto r = mix(sa,sb,a);
+          q[0][b] = r.rotation.x;
+          q[1][b] = r.rotation.y;
+          q[2][b] = r.rotation.z;
+          q[3][b] = r.rotation.w;
+          }
+        x = _mm_load_ps(q[0]);
+        y = _mm_load_ps(q[1]);
+        z = _mm_load_ps(q[2]);
+        w = _mm_load_ps(q[3]);
+        }
+
+      __m128 px = _mm_add_ps(_mm_load_ps(pa[0]+i),_mm_mul_ps(_mm_sub_ps(_mm_load_ps(pb[0]+i),_mm_load_ps(pa[0]+i)),ta));
+      __m128 py = _mm_add_ps(_mm_load_ps(pa[1]+i),_mm_mul_ps(_mm_sub_ps(_mm_load_ps(pb[1]+i),_mm_load_ps(pa[1]+i)),ta));
+      __m128 pz = _mm_add_ps(_mm_load_ps(pa[2]+i),_mm_mul_ps(_mm_sub_ps(_mm_load_ps(pb[2]+i),_mm_load_ps(pa[2]+i)),ta));
+
+      __m128 xx = _mm_mul_ps(x,x), yy = _mm_mul_ps(y,y), zz = _mm_mul_ps(z,z), ww = _mm_mul_ps(w,w);
+      __m128 xy = _mm_mul_ps(x,y), xz = _mm_mul_ps(x,z), yz = _mm_mul_ps(y,z);
+      __m128 wx = _mm_mul_ps(w,x), wy = _mm_mul_ps(w,y), wz = _mm_mul_ps(w,z);
+
+      __m128 r0 = _mm_sub_ps(_mm_add_ps(ww,xx),_mm_add_ps(yy,zz));
+      __m128 r1 = _mm_mul_ps(two,_mm_sub_ps(xy,wz));
+      __m128 r2 = _mm_mul_ps(two,_mm_add_ps(xz,wy));
+      __m128 r3 = _mm_setzero_ps();
+      __m128 u0 = _mm_mul_ps(two,_mm_add_ps(xy,wz));
+      __m128 u1 = _mm_sub_ps(_mm_add_ps(ww,yy),_mm_add_ps(xx,zz));
+      __m128 u2 = _mm_mul_ps(two,_mm_sub_ps(yz,wx));
+      __m128 u3 = _mm_setzero_ps();
+      __m128 v0 = _mm_mul_ps(two,_mm_sub_ps(xz,wy));
+      __m128 v1 = _mm_mul_ps(two,_mm_add_ps(yz,wx));
+      __m128 v2 = _mm_sub_ps(_mm_add_ps(ww,zz),_mm_add_ps(xx,yy));
+      __m128 v3 = _mm_setzero_ps();
+      __m128 pw = one;
+      // SoA -> one matrix per lane
+      _MM_TRANSPOSE4_PS(r0,r1,r2,r3);
+      _MM_TRANSPOSE4_PS(u0,u1,u2,u3);
+      _MM_TRANSPOSE4_PS(v0,v1,v2,v3);
+      _MM_TRANSPOSE4_PS(px,py,pz,pw);
+
+      const __m128 row[4][4] = {{r0,u0,v0,px},{r1,u1,v1,py},{r2,u2,v2,pz},{r3,u3,v3,pw}};
+      for(size_t b=0; b<4 && i+b<cnt; ++b) {
+        const size_t idx = nodeIndex[trk[i+b]];
+        alignas(16) float mt[16];
+        _mm_store_ps(mt+ 0,row[b][0]);
+        _mm_store_ps(mt+ 4,row[b][1]);
+        _mm_store_ps(mt+ 8,row[b][2]);
+        _mm_store_ps(mt+12,row[b][3]);
+        out[idx] = Tempest::Matrix4x4(mt);
+        }
+      }
+#endif
+    for(; i<cnt; ++i) {
+      const size_t idx = nodeIndex[trk[i]];
+      ZenLoad::zCModelAniSample sa, sb;
+      sa.rotation = ZMath::float4{qa[0][i],qa[1][i],qa[2][i],qa[3][i]};
+      sb.rotation = ZMath::float4{qb[0][i],qb[1][i],qb[2][i],qb[3][i]};
+      sa.position = ZMath::float3{pa[0][i],pa[1][i],pa[2][i]};
+      sb.position = ZMath::float3{pb[0][i],pb[1][i],pb[2][i]};
+      out[idx] = mkMatrix(mix(sa,sb,a));
+      }
+    }
+  }
+
+PackedSamples::BenchStats PackedSamples::bench(uint32_t tracks, uint32_t frames, uint32_t iterations) {
+  using Clock = std::chrono::steady_clock;
+  auto usSince = [](Clock::time_point t) {
+    return uint64_t(std::chrono::duration_cast<std::chrono::microseconds>(Clock::now()-t).count());
+    };
+
+  BenchStats st;
+  st.tracks = tracks;
+  st.frames = frames;
+  if(tracks==0 || frames<2)
+    return st;
+
+  // deterministic clip, close to skeletal animations: every bone rotates around own axis,
+  // every third one is static; only root and every 8-th bone have animated position
+  uint32_t seed = 12345;
+  auto rnd = [&seed]() {
+    seed = seed*1664525u+1013904223u;
+    return float(seed>>8)/float(1u<<24)*2.f-1.f;
+    };
+  std::vector<ZenLoad::zCModelAniSample> samples(size_t(tracks)*frames);
+  for(uint32_t t=0; t<tracks; ++t) {
+    float ax = rnd(), ay = rnd(), az = rnd()+2.f;
+    float l  = std::sqrt(ax*ax+ay*ay+az*az);
+    float ph = rnd()*3.f;
+    ZMath::float3 p0 = {rnd()*20.f, rnd()*20.f, rnd()*20.f};
+    for(uint32_t f=0; f<frames; ++f) {
+      auto& s   = samples[size_t(f)*tracks+t];
+      float ang = (t%3==2) ? ph : ph+float(f)*0.05f;
+      float sn  = std::sin(ang*0.5f);
+      s.rotation = ZMath::float4{ax/l*sn, ay/l*sn, az/l*sn, std::cos(ang*0.5f)};
+      s.position = p0;
+      if(t%8==0) {
+        s.position.x += float(f)*3.f;
+        s.position.y += std::sin(float(f)*0.2f)*10.f;
+        }
+      }
+    }
+
+  PackedSamples pk;
+  pk.pack(samples,tracks);
+  st.rawBytes    = samples.size()*sizeof(samples[0]);
+  st.packedBytes = pk.memoryUsage();
+
+  std::vector<uint32_t>           node(tracks);
+  std::vector<Tempest::Matrix4x4> ref(tracks), out(tracks);
+  for(uint32_t i=0; i<tracks; ++i)
+    node[i] = i;
+
+  for(uint32_t f=0; f+1<frames; ++f) {
+    for(float a:{0.f, 0.3f, 0.77f}) {
+      auto* sa = &samples[size_t(f)*tracks];
+      auto* sb = &samples[size_t(f+1)*tracks];
+      pk.decode(f,f+1,a,node.data(),out.data(),tracks);
+      for(uint32_t t=0; t<tracks; ++t) {
+        ref[t] = mkMatrix(mix(sa[t],sb[t],a));
+        for(int x=0; x<3; ++x)
+          for(int y=0; y<3; ++y)
+            st.rotError = std::max(st.rotError,std::abs(ref[t].at(x,y)-out[t].at(x,y)));
+        for(int y=0; y<3; ++y)
+          st.posError = std::max(st.posError,std::abs(ref[t].at(3,y)-out[t].at(3,y)));
+        }
+      }
+    }
+
+  auto t = Clock::now();
+  for(uint32_t i=0; i<iterations; ++i) {
+    const uint32_t f  = i%(frames-1);
+    auto*          sa = &samples[size_t(f)*tracks];
+    auto*          sb = &samples[size_t(f+1)*tracks];
+    for(uint32_t b=0; b<tracks; ++b)
+      ref[b] = mkMatrix(mix(sa[b],sb[b],0.5f));
+    }
+  st.rawUs = usSince(t);
+
+  t = Clock::now();
+  for(uint32_t i=0; i<iterations; ++i) {
+    const uint32_t f = i%(frames-1);
+    pk.decode(f,f+1,0.5f,node.data(),out.data(),tracks);
+    }
+  st.packedUs = usSince(t);
+  return st;
+  }
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <zenload/zTypes.h>
+#include <Tempest/Matrix4x4>
+#include <Tempest/Point>
+
+#include <vector>
+#include <cstdint>
+
+// Compact storage of skeletal animation samples:
+//  * constant tracks are reduced to a single key
+//  * rotations are quantized with 'smallest three' scheme (48 bit per key)
+//  * positions are quantized to 16 bit per component, relative to the track range
+class PackedSamples final {
+  public:
+    PackedSamples() = default;
+
+    void     pack(const std::vector<ZenLoad::zCModelAniSample>& samples, size_t numTracks);
+    bool     isEmpty()   const { return numTracks==0 || numFrames==0; }
+    uint32_t frameCount() const { return numFrames; }
+    size_t   memoryUsage() const;
+
+    // interpolates frameA..frameB and writes matrix of track 'i' into out[nodeIndex[i]]
+    // nodes with skip[node]!=0 are left untouched
+    void     decode(uint32_t frameA, uint32_t frameB, float a,
+                    const uint32_t* nodeIndex, Tempest::Matrix4x4* out, size_t outSize,
+                    const uint8_t* skip = nullptr) const;
+
+    // debug: packs synthetic clip and compares decode against raw samples with mix+mkMatrix
+    struct BenchStats {
+      uint32_t  tracks      = 0;
+      uint32_t  frames      = 0;
+      size_t    rawBytes    = 0;
+      size_t    packedBytes = 0;
+      float     rotError    = 0; // max abs difference in rotation part of bone matrix
+      float     posError    = 0; // max abs difference in translation
+      uint64_t  rawUs       = 0;
+      uint64_t  packedUs    = 0;
+      };
+    static BenchStats bench(uint32_t tracks, uint32_t frames, uint32_t iterations);
+
+  private:
+    struct RotKey {
+      uint16_t v[3] = {};
+      };
+
+    struct PosKey {
+      uint16_t v[3] = {};
+      };
+
+    struct PosRange {
+      Tempest::Vec3 min;
+      Tempest::Vec3 scale;
+      };
+
+    uint32_t                     numTracks = 0;
+    uint32_t                     numFrames = 0;
+
+    // per track: index into constant or animated arrays, high bit set for animated tracks
+    std::vector<uint32_t>        rotTrack, posTrack;
+
+    std::vector<ZMath::float4>   rotConst;
+    std::vector<ZMath::float3>   posConst;
+
+    // animated keys are stored frame-major: key[frame*animated.size() + track]
+    std::vector<uint32_t>        rotAnim, posAnim;
+    std::vector<RotKey>          rotKeys;
+    std::vector<PosKey>          posKeys;
+    std::vector<PosRange>        posRange;
+
+    static RotKey                packRot  (const ZMath::float4& q);
+    static void                  unpackRot(const RotKey& k, float& x, float& y, float& z, float& w);
+  };
@@ -292,7 +292,7 @@ void Pose::processLayers(AnimationSolver& solver, uint64_t tickCount) {
     }
   }
 
-bool Pose::update(uint64_t tickCount) {
+bool Pose::update(uint64_t tickCount, Lod lod, PoseCache* cache) {
   if(lay.size()==0){
     if(lastUpdate==0){
       zeroSkeleton();
@@ -307,13 +307,22 @@ bool Pose::update(uint64_t tickCount) {
     }
 
   if(lastUpdate!=tickCount) {
+    bool changed = false;
+    if(cache!=nullptr && updateShared(*cache,tickCount,changed))
+      return changed;
+    if(sharedKey.skeleton!=nullptr) {
+      // cache hits fill 'tr' only - 'base' is outdated: decode all bones once
+      needToUpdate = true;
+      lod          = LodFull;
+      sharedKey    = PoseCache::Key();
+      }
     for(auto& i:lay) {
       const Animation::Sequence* seq = i.seq;
       if(0<i.comb && i.comb<=i.seq->comb.size()) {
         if(auto sx = i.seq->comb[size_t(i.comb-1)])
           seq = sx;
         }
-      needToUpdate |= updateFrame(*seq,lastUpdate,i.sAnim,tickCount);
+      needToUpdate |= updateFrame(*seq,lastUpdate,i.sAnim,tickCount,lod);
       }
     lastUpdate = tickCount;
     }
@@ -327,16 +336,30 @@ bool Pose::update(uint64_t tickCount) {
   }
 
 bool Pose::updateFrame(const Animation::Sequence &s,
-                       uint64_t barrier, uint64_t sTime, uint64_t now) {
+                       uint64_t barrier, uint64_t sTime, uint64_t now, Lod lod) {
   auto&        d         = *s.data;
   const size_t numFrames = d.numFrames;
   const size_t idSize    = d.nodeIndex.size();
-  if(numFrames==0 || idSize==0 || d.samples.size()%idSize!=0)
+  if(numFrames==0 || idSize==0 || d.samples.isEmpty())
     return false;
   if(numFrames==1 && !needToUpdate)
     return false;
 
   (void)barrier;
+  uint32_t frameA = 0, frameB = 0;
+  float    a      = 0;
+  frameOf(s,sTime,now,frameA,frameB,a);
+
+  const uint8_t* skip = nullptr;
+  if(lod>=LodReduced && skeleton!=nullptr && skeleton->detail.size()>=numBones)
+    skip = skeleton->detail.data();
+  d.samples.decode(frameA,frameB,a,d.nodeIndex.data(),base,numBones,skip);
+  return true;
+  }
+
+void Pose::frameOf(const Animation::Sequence& s, uint64_t sTime, uint64_t now,
+                   uint32_t& fA, uint32_t& fB, float& a) {
+  auto& d = *s.data;
   now = now-sTime;
 
   float    fpsRate = d.fpsRate;
@@ -344,7 +367,7 @@ bool Pose::updateFrame(const Animation::Sequence &s,
   uint64_t frameA  = frame/1000;
   uint64_t frameB  = frame/1000+1; //next
 
-  float    a       = float(frame%1000)/1000.f;
+  a = float(frame%1000)/1000.f;
 
   if(s.animCls==Animation::Loop){
     frameA%=d.numFrames;
@@ -358,17 +381,70 @@ bool Pose::updateFrame(const Animation::Sequence &s,
     frameA = d.numFrames-1-frameA;
     frameB = d.numFrames-1-frameB;
     }
+  fA = uint32_t(frameA);
+  fB = uint32_t(frameB);
+  }
 
-  auto* sampleA = &d.samples[size_t(frameA*idSize)];
-  auto* sampleB = &d.samples[size_t(frameB*idSize)];
+bool Pose::mkSharedKey(PoseCache::Key& key, uint64_t tickCount) const {
+  // per-npc state, that is not part of the key
+  if(skeleton==nullptr || numBones==0 || headRotX!=0 || headRotY!=0)
+    return false;
+  if(lay.size()>PoseCache::MaxLayers || lay[0].bs==BS_CLIMB)
+    return false;
 
-  for(size_t i=0; i<idSize; ++i) {
-    size_t idx = d.nodeIndex[i];
-    if(idx>=numBones)
-      continue;
-    auto smp = mix(sampleA[i],sampleB[i],a);
-    base[idx] = mkMatrix(smp);
+  key.skeleton = skeleton;
+  key.root     = lay[0].seq;
+  key.bs       = lay[0].bs;
+  key.flags    = uint8_t(flag);
+  key.count    = uint8_t(lay.size());
+  for(size_t i=0; i<lay.size(); ++i) {
+    const Animation::Sequence* seq = lay[i].seq;
+    if(0<lay[i].comb && lay[i].comb<=seq->comb.size()) {
+      if(auto sx = seq->comb[size_t(lay[i].comb-1)])
+        seq = sx;
+      }
+    auto& d = *seq->data;
+    if(d.numFrames==0 || d.samples.isEmpty())
+      return false;
+    // bones, that are not animated by base layer, would keep history of this pose
+    if(i==0 && d.nodeIndex.size()<numBones)
+      return false;
+
+    float a = 0;
+    auto& l = key.lay[i];
+    l.seq = seq;
+    frameOf(*seq,lay[i].sAnim,tickCount,l.frameA,l.frameB,a);
+    l.alpha = uint8_t(a*PoseCache::TimeSteps+0.5f);
+    if(l.alpha>=PoseCache::TimeSteps) {
+      l.frameA = l.frameB;
+      l.alpha  = 0;
+      }
+    }
+  return true;
+  }
+
+bool Pose::updateShared(PoseCache& cache, uint64_t tickCount, bool& changed) {
+  PoseCache::Key key;
+  if(!mkSharedKey(key,tickCount))
+    return false;
+
+  lastUpdate = tickCount;
+  changed    = (needToUpdate || key!=sharedKey);
+  if(!changed)
+    return true;
+
+  sharedKey    = key;
+  needToUpdate = false;
+  if(cache.fetch(key,tr,numBones))
+    return true;
+
+  for(size_t i=0; i<key.count; ++i) {
+    auto& l = key.lay[i];
+    auto& d = *l.seq->data;
+    d.samples.decode(l.frameA,l.frameB,float(l.alpha)/PoseCache::TimeSteps,d.nodeIndex.data(),base,numBones);
     }
+  mkSkeleton(*lay[0].seq,lay[0].bs);
+  cache.store(key,tr,numBones);
   return true;
   }
 
@@ -376,9 +452,7 @@ void Pose::mkSkeleton(const Animation::Sequence &s, BodyState bs) {
   if(skeleton==nullptr)
     return;
   Matrix4x4 m = mkBaseTranslation(&s,bs);
-  if(skeleton->ordered)
-    mkSkeleton(m); else
-    mkSkeleton(m,size_t(-1));
+  mkSkeleton(m);
   }
 
 void Pose::mkSkeleton(const Matrix4x4 &mt) {
@@ -386,12 +460,12 @@ void Pose::mkSkeleton(const Matrix4x4 &mt) {
     return;
   auto& nodes      = skeleton->nodes;
   auto  BIP01_HEAD = skeleton->BIP01_HEAD;
-  for(size_t i=0; i<nodes.size(); ++i) {
+  for(auto i:skeleton->order) {
     size_t parent = nodes[i].parent;
     if(parent<Resources::MAX_NUM_SKELETAL_NODES) {
-      tr[i] = tr[parent]*base[i];
+      mulMatrix(tr[i],tr[parent],base[i]);
       } else {
-      tr[i] = mt*base[i];
+      mulMatrix(tr[i],mt,base[i]);
       }
     if(i==BIP01_HEAD && (headRotX!=0 || headRotY!=0)) {
       Matrix4x4& m = tr[i];
@@ -401,18 +475,6 @@ void Pose::mkSkeleton(const Matrix4x4 &mt) {
     }
   }
 
-void Pose::mkSkeleton(const Tempest::Matrix4x4 &mt, size_t parent) {
-  if(skeleton==nullptr)
-    return;
-  auto& nodes = skeleton->nodes;
-  for(size_t i=0;i<nodes.size();++i){
-    if(nodes[i].parent!=parent)
-      continue;
-    tr[i] = mt*base[i];
-    mkSkeleton(tr[i],i);
-    }
-  }
-
 const Animation::Sequence* Pose::getNext(const AnimationSolver &solver, const Layer& lay) {
   auto sq = lay.seq;
 
@@ -609,9 +671,9 @@ bool Pose::isIdle() const {
   return true;
   }
 
-bool Pose::isInAnim(std::string_view sq) const {
+bool Pose::isInAnim(StrId sq) const {
   for(auto& i:lay)
-    if(i.seq->name==sq)
+    if(i.seq->nameId==sq)
       return true;
   return false;
   }
@@ -7,6 +7,7 @@
 
 #include "game/constants.h"
 #include "animation.h"
+#include "posecache.h"
 #include "resources.h"
 
 class Skeleton;
@@ -29,6 +30,12 @@ class Pose final {
       NoInterupt = 0x2,
       };
 
+    enum Lod : uint8_t {
+      LodFull    = 0,
+      LodReduced = 1, // detail bones (fingers, toes) keep last sampled transform
+      LodFrozen  = 2, // pose is not updated at all
+      };
+
     static uint8_t     calcAniComb(const Tempest::Vec3& dpos, float rotation);
     static uint8_t     calcAniCombVert(const Tempest::Vec3& dpos);
 
@@ -45,7 +52,7 @@ class Pose final {
     bool               stopWalkAnim();
     void               interrupt();
     void               stopAllAnim();
-    bool               update(uint64_t tickCount);
+    bool               update(uint64_t tickCount, Lod lod = LodFull, PoseCache* cache = nullptr);
 
     void               processLayers(AnimationSolver &solver, uint64_t tickCount);
     void               processEvents(uint64_t& barrier, uint64_t now, Animation::EvCount &ev) const;
@@ -62,7 +69,7 @@ class Pose final {
     bool               isStanding() const;
     bool               isPrehit(uint64_t now) const;
     bool               isIdle() const;
-    bool               isInAnim(std::string_view           sq) const;
+    bool               isInAnim(StrId                      sq) const;
     bool               isInAnim(const Animation::Sequence* sq) const;
     bool               hasAnim() const;
     uint64_t           animationTotalTime() const;
@@ -94,10 +101,12 @@ class Pose final {
     auto mkBaseTranslation(const Animation::Sequence *s, BodyState bs) -> Tempest::Matrix4x4;
     void mkSkeleton(const Animation::Sequence &s, BodyState bs);
     void mkSkeleton(const Tempest::Matrix4x4 &mt);
-    void mkSkeleton(const Tempest::Matrix4x4 &mt, size_t parent);
     void zeroSkeleton();
 
-    bool updateFrame(const Animation::Sequence &s, uint64_t barrier, uint64_t sTime, uint64_t now);
+    bool updateFrame(const Animation::Sequence &s, uint64_t barrier, uint64_t sTime, uint64_t now, Lod lod);
+    bool updateShared(PoseCache& cache, uint64_t tickCount, bool& changed);
+    bool mkSharedKey(PoseCache::Key& key, uint64_t tickCount) const;
+    static void frameOf(const Animation::Sequence &s, uint64_t sTime, uint64_t now, uint32_t& frameA, uint32_t& frameB, float& a);
 
     const Animation::Sequence* getNext(const AnimationSolver& solver, const Layer& lay);
 
@@ -132,6 +141,7 @@ class Pose final {
     uint8_t                         isFlyCombined = 0;
 
     float                           headRotX = 0, headRotY = 0;
+    PoseCache::Key                  sharedKey;
 
     size_t                          numBones = 0;
     Tempest::Matrix4x4              base[Resources::MAX_NUM_SKELETAL_NODES];
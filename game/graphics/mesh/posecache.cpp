@@ -0,0 +1,61 @@
+#include "posecache.h"
+
+#include <cstring>
+
+bool PoseCache::Layer::operator ==(const Layer& other) const {
+  return seq==other.seq && frameA==other.frameA && frameB==other.frameB && alpha==other.alpha;
+  }
+
+bool PoseCache::Key::operator ==(const Key& other) const {
+  if(skeleton!=other.skeleton || root!=other.root || bs!=other.bs || flags!=other.flags || count!=other.count)
+    return false;
+  for(size_t i=0; i<count; ++i)
+    if(!(lay[i]==other.lay[i]))
+      return false;
+  return true;
+  }
+
+size_t PoseCache::Key::hash() const {
+  auto mix = [](size_t h, size_t v) {
+    return h ^ (v + size_t(0x9e3779b9) + (h<<6) + (h>>2));
+    };
+  size_t h = std::hash<const void*>()(skeleton);
+  h = mix(h,std::hash<const void*>()(root));
+  h = mix(h,size_t(bs)<<8 | flags);
+  for(size_t i=0; i<count; ++i) {
+    h = mix(h,std::hash<const void*>()(lay[i].seq));
+    h = mix(h,size_t(lay[i].frameA));
+    h = mix(h,size_t(lay[i].frameB)<<8 | lay[i].alpha);
+    }
+  return h;
+  }
+
+void PoseCache::reset() {
+  std::lock_guard<std::mutex> guard(sync);
+  index.clear();
+  palette.clear();
+  statsPrev = statsCur;
+  statsCur  = Stats();
+  }
+
+bool PoseCache::fetch(const Key& k, Tempest::Matrix4x4* tr, size_t count) {
+  std::lock_guard<std::mutex> guard(sync);
+  auto it = index.find(k);
+  if(it==index.end() || it->second.count!=count) {
+    statsCur.misses++;
+    return false;
+    }
+  std::memcpy(static_cast<void*>(tr),&palette[it->second.offset],count*sizeof(Tempest::Matrix4x4));
+  statsCur.hits++;
+  return true;
+  }
+
+void PoseCache::store(const Key& k, const Tempest::Matrix4x4* tr, size_t count) {
+  std::lock_guard<std::mutex> guard(sync);
+  auto ins = index.emplace(k,Entry());
+  if(!ins.second)
+    return;
+  ins.first->second.offset = palette.size();
+  ins.first->second.count  = count;
+  palette.insert(palette.end(),tr,tr+count);
+  }
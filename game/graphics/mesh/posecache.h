@@ -0,0 +1,71 @@
+#pragma once
+
+#include <Tempest/Matrix4x4>
+
+#include <vector>
+#include <mutex>
+#include <unordered_map>
+
+#include "game/constants.h"
+#include "animation.h"
+
+class Skeleton;
+
+// Per-frame cache of computed bone palettes.
+// Npc's, that play same animations on same skeleton, in same (quantized) time, get identical pose.
+class PoseCache final {
+  public:
+    PoseCache() = default;
+
+    enum : uint8_t {
+      MaxLayers = 4,
+      TimeSteps = 4, // interpolation steps in between of two key-frames
+      };
+
+    struct Layer final {
+      const Animation::Sequence* seq    = nullptr;
+      uint32_t                   frameA = 0;
+      uint32_t                   frameB = 0;
+      uint8_t                    alpha  = 0;
+
+      bool operator == (const Layer& other) const;
+      };
+
+    struct Key final {
+      const Skeleton*            skeleton = nullptr;
+      const Animation::Sequence* root     = nullptr;
+      BodyState                  bs       = BS_NONE;
+      uint8_t                    flags    = 0;
+      uint8_t                    count    = 0;
+      Layer                      lay[MaxLayers];
+
+      bool   operator == (const Key& other) const;
+      bool   operator != (const Key& other) const { return !(*this==other); }
+      size_t hash() const;
+      };
+
+    struct Stats final {
+      uint32_t hits   = 0;
+      uint32_t misses = 0;
+      };
+
+    void   reset();
+    bool   fetch(const Key& k, Tempest::Matrix4x4* tr, size_t count);
+    void   store(const Key& k, const Tempest::Matrix4x4* tr, size_t count);
+    auto   stats() const -> const Stats& { return statsPrev; }
+
+  private:
+    struct Hash {
+      size_t operator()(const Key& k) const { return k.hash(); }
+      };
+
+    struct Entry {
+      size_t offset = 0;
+      size_t count  = 0;
+      };
+
+    std::mutex                              sync;
+    std::unordered_map<Key,Entry,Hash>      index;
+    std::vector<Tempest::Matrix4x4>         palette;
+    Stats                                   statsCur, statsPrev;
+  };
@@ -36,6 +36,8 @@ Skeleton::Skeleton(const ZenLoad::zCModelMeshLib& src, const Animation* anim, st
   for(size_t i=0;i<nodes.size();++i)
     if(nodes[i].parent==size_t(-1))
       rootNodes.push_back(i);
+  mkOrder();
+  mkDetail();
 
   auto tr = src.getRootNodeTranslation();
   rootTr = Vec3{tr.x,tr.y,tr.z};
@@ -85,6 +87,32 @@ float Skeleton::colisionRadius() const {
   return std::max(x,y); //TODO
   }
 
+void Skeleton::mkOrder() {
+  order.reserve(nodes.size());
+  if(ordered) {
+    for(size_t i=0;i<nodes.size();++i)
+      order.push_back(i);
+    return;
+    }
+  order = rootNodes;
+  for(size_t r=0;r<order.size();++r) {
+    for(size_t i=0;i<nodes.size();++i)
+      if(nodes[i].parent==order[r])
+        order.push_back(i);
+    }
+  }
+
+void Skeleton::mkDetail() {
+  detail.resize(nodes.size());
+  for(auto i:order) {
+    auto& n = nodes[i];
+    if(n.name.find("FINGER")!=std::string::npos || n.name.find("TOE")!=std::string::npos)
+      detail[i] = 1;
+    else if(n.parent<nodes.size())
+      detail[i] = detail[n.parent];
+    }
+  }
+
 void Skeleton::mkSkeleton() {
   Matrix4x4 m;
   m.identity();
@@ -21,6 +21,8 @@ class Skeleton final {
     bool                            ordered=true;
     std::vector<Node>               nodes;
     std::vector<size_t>             rootNodes;
+    std::vector<size_t>             order;     // parents before children
+    std::vector<uint8_t>            detail;    // fingers and toes, skipped by reduced animation lod
     std::vector<Tempest::Matrix4x4> tr;
     Tempest::Vec3                   rootTr={};
 
@@ -43,6 +45,8 @@ class Skeleton final {
     std::string      fileName;
     const Animation* anim=nullptr;
 
+    void mkOrder();
+    void mkDetail();
     void mkSkeleton();
     void mkSkeleton(const Tempest::Matrix4x4& mt,size_t parent);
   };
@@ -78,6 +78,12 @@ const Bounds& ObjectsBucket::Item::bounds() const {
   return b;
   }
 
+bool ObjectsBucket::Item::isVisible() const {
+  if(owner!=nullptr)
+    return owner->isVisible(id);
+  return false;
+  }
+
 void ObjectsBucket::Item::draw(Tempest::Encoder<Tempest::CommandBuffer>& p, uint8_t fId) const {
   owner->draw(id,p,fId);
   }
@@ -547,6 +553,10 @@ const Bounds& ObjectsBucket::bounds(size_t i) const {
   return val[i].visibility.bounds();
   }
 
+bool ObjectsBucket::isVisible(size_t i) const {
+  return val[i].visibility.isVisible();
+  }
+
 bool ObjectsBucket::Storage::commitUbo(uint8_t fId) {
   return mat.commitUbo(fId);
   }
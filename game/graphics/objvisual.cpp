@@ -219,9 +219,9 @@ bool ObjVisual::isAnimExist(std::string_view name) const {
   return false;
   }
 
-bool ObjVisual::updateAnimation(Npc* npc, World& world) {
+bool ObjVisual::updateAnimation(Npc* npc, World& world, Pose::Lod lod) {
   if(type==M_Mdl) {
-    bool ret = mdl.view.updateAnimation(npc,world);
+    bool ret = mdl.view.updateAnimation(npc,world,lod);
     if(ret)
       mdl.view.syncAttaches();
     return ret;
@@ -229,6 +229,12 @@ bool ObjVisual::updateAnimation(Npc* npc, World& world) {
   return false;
   }
 
+bool ObjVisual::isVisible() const {
+  if(type==M_Mdl)
+    return mdl.view.isVisible();
+  return false;
+  }
+
 void ObjVisual::processLayers(World& world) {
   if(type==M_Mdl) {
     mdl.view.processLayers(world);
@@ -85,7 +85,7 @@ void Renderer::resetSwapchain() {
   copyPass    = device.pass(FboMode::PreserveOut);
 
   if(auto wview=Gothic::inst().worldView()) {
-    wview->setFrameGlobals(nullptr,0,0);
+    wview->setFrameGlobals(nullptr,nullptr,0,0);
     wview->setGbuffer(Resources::fallbackBlack(),Resources::fallbackBlack(),Resources::fallbackBlack(),Resources::fallbackBlack());
     }
 
@@ -133,18 +133,18 @@ void Renderer::draw(Tempest::Encoder<CommandBuffer>& cmd,
 
   wview->setViewProject(view,proj);
   wview->setModelView(viewProj,shadow,Resources::ShadowLayers);
+  wview->setGbuffer(textureCast(lightingBuf),textureCast(gbufDiffuse),textureCast(gbufNormal),textureCast(gbufDepth));
+
+  {
   const Texture2d* sh[Resources::ShadowLayers];
   for(size_t i=0; i<Resources::ShadowLayers; ++i)
     sh[i] = &textureCast(shadowMap[i]);
-  wview->setFrameGlobals(sh,Gothic::inst().world()->tickCount(),cmdId);
-  wview->setGbuffer(textureCast(lightingBuf),textureCast(gbufDiffuse),textureCast(gbufNormal),textureCast(gbufDepth));
 
-  {
   Frustrum f[SceneGlobals::V_Count];
   f[SceneGlobals::V_Shadow0].make(shadow[0],fboShadow[0].w(),fboShadow[0].h());
   f[SceneGlobals::V_Shadow1].make(shadow[1],fboShadow[1].w(),fboShadow[1].h());
   f[SceneGlobals::V_Main   ].make(viewProj,fbo.w(),fbo.h());
-  wview->visibilityPass(f);
+  wview->setFrameGlobals(sh,f,Gothic::inst().world()->tickCount(),cmdId);
   }
 
   for(uint8_t i=0; i<Resources::ShadowLayers; ++i) {
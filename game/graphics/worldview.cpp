@@ -15,6 +15,7 @@ WorldView::WorldView(const World &world, const PackedMesh &wmesh)
     objGroup(visuals),pfxGroup(*this,sGlobal,visuals),land(visuals,wmesh) {
   visuals.setWorld(owner);
   pfxGroup.resetTicks();
+  mkFrameGraph();
   }
 
 WorldView::~WorldView() {
@@ -46,7 +47,21 @@ void WorldView::setModelView(const Matrix4x4& viewProj, const Tempest::Matrix4x4
   sGlobal.setModelView(viewProj,shadow,shCount);
   }
 
-void WorldView::setFrameGlobals(const Texture2d* shadow[], uint64_t tickCount, uint8_t fId) {
+void WorldView::mkFrameGraph() {
+  // cpu-only stages; gpu uploads stay on render thread
+  frameGraph.stage("visibility", 0, R_Visibility, [this](){
+    if(frame.fr!=nullptr)
+      visuals.visibilityPass(frame.fr);
+    });
+  frameGraph.stage("particles",  0, R_Particles, [this](){
+    pfxGroup.tick(frame.tickCount);
+    });
+  frameGraph.stage("lights",     0, R_Lights, [this](){
+    sGlobal.lights.tick(frame.tickCount);
+    });
+  }
+
+void WorldView::setFrameGlobals(const Texture2d* shadow[], const Frustrum fr[], uint64_t tickCount, uint8_t fId) {
   auto& device = Resources::device();
 
   const Texture2d* shNull[Resources::ShadowLayers];
@@ -67,13 +82,20 @@ void WorldView::setFrameGlobals(const Texture2d* shadow[], uint64_t tickCount, u
     sGlobal.setShadowMap(shadow);
     visuals.setupUbo();
     }
-  pfxGroup.tick(tickCount);
-  sGlobal.lights.tick(tickCount);
+
+  frame.fr        = fr;
+  frame.tickCount = tickCount;
+  frameGraph.start();
+
+  // material animation doesn't depend on any of frame stages - upload in meantime
   sGlobal .setTime(tickCount);
   sGlobal .commitUbo(fId);
+  visuals .preFrameUpdate(fId);
+
+  frameGraph.wait();
+  frame.fr = nullptr;
 
   sGlobal.lights.preFrameUpdate(fId);
-  visuals .preFrameUpdate(fId);
   pfxGroup.preFrameUpdate(fId);
   }
 
@@ -97,10 +119,6 @@ void WorldView::dbgLights(DbgPainter& p) const {
   sGlobal.lights.dbgLights(p);
   }
 
-void WorldView::visibilityPass(const Frustrum fr[]) {
-  visuals.visibilityPass(fr);
-  }
-
 void WorldView::drawShadow(Tempest::Encoder<CommandBuffer>& cmd, uint8_t fId, uint8_t layer) {
   visuals.drawShadow(cmd,fId,layer);
   }
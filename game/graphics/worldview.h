@@ -8,6 +8,7 @@
 #include "graphics/meshobjects.h"
 #include "graphics/mesh/protomesh.h"
 #include "graphics/pfx/pfxobjects.h"
+#include "utils/framegraph.h"
 #include "lightsource.h"
 #include "sceneglobals.h"
 #include "visualobjects.h"
@@ -32,13 +33,12 @@ class WorldView {
     void setViewProject (const Tempest::Matrix4x4& view, const Tempest::Matrix4x4& proj);
     void setModelView   (const Tempest::Matrix4x4& viewProj, const Tempest::Matrix4x4* shadow, size_t shCount);
 
-    void setFrameGlobals(const Tempest::Texture2d* shadow[], uint64_t tickCount, uint8_t fId);
+    void setFrameGlobals(const Tempest::Texture2d* shadow[], const Frustrum fr[], uint64_t tickCount, uint8_t fId);
     void setGbuffer     (const Tempest::Texture2d& lightingBuf, const Tempest::Texture2d& diffuse, const Tempest::Texture2d& norm, const Tempest::Texture2d& depth);
     void setupUbo();
 
     void dbgLights    (DbgPainter& p) const;
 
-    void visibilityPass(const Frustrum fr[]);
     void drawShadow    (Tempest::Encoder<Tempest::CommandBuffer> &cmd, uint8_t frameId, uint8_t layer);
     void drawGBuffer   (Tempest::Encoder<Tempest::CommandBuffer> &cmd, uint8_t frameId);
     void drawMain      (Tempest::Encoder<Tempest::CommandBuffer> &cmd, uint8_t frameId);
@@ -64,10 +64,25 @@ class WorldView {
 
     bool          needToUpdateUbo = false;
 
+    // camera and animation are finished before frame graph starts - not modeled as resources
+    enum FrameResource : uint64_t {
+      R_Visibility = 1<<0,
+      R_Particles  = 1<<1,
+      R_Lights     = 1<<2,
+      };
+
+    struct FrameParams {
+      const Frustrum* fr        = nullptr;
+      uint64_t        tickCount = 0;
+      };
+    FrameParams   frame;
+    FrameGraph    frameGraph;
+
     bool needToUpdateCmd(uint8_t frameId) const;
     void invalidateCmd();
 
     void updateLight();
+    void mkFrameGraph();
 
   friend class LightGroup::Light;
   friend class PfxEmitter;
@@ -8,6 +8,7 @@
 #include <Tempest/Layout>
 #include <Tempest/Application>
 #include <Tempest/Log>
+#include <Tempest/MemWriter>
 
 #include "ui/dialogmenu.h"
 #include "ui/gamemenu.h"
@@ -17,6 +18,7 @@
 
 #include "world/objects/npc.h"
 #include "game/serialize.h"
+#include "game/savefile.h"
 #include "game/globaleffects.h"
 #include "utils/crashlog.h"
 #include "utils/gthfont.h"
@@ -191,8 +193,15 @@ void MainWindow::paintEvent(PaintEvent& event) {
     }
 
   if(Gothic::inst().doFrate()) {
-    char fpsT[64]={};
-    std::snprintf(fpsT,sizeof(fpsT),"fps = %.2f %s",fps.get(),info);
+    char fpsT[256]={};
+    if(world!=nullptr) {
+      auto& ai = world->aiLodStats();
+      auto& ps = world->poseCache().stats();
+      std::snprintf(fpsT,sizeof(fpsT),"fps = %.2f ai = %u/%u/%u[%u] ray = %u/%u pose = %u/%u %s",fps.get(),
+                    ai.aiNormal,ai.aiFar,ai.aiFar2,ai.ticked,ai.rayHits,ai.rayPrefetch,ps.hits,ps.misses,info);
+      } else {
+      std::snprintf(fpsT,sizeof(fpsT),"fps = %.2f %s",fps.get(),info);
+      }
 
     auto& fnt = Resources::font();
     fnt.drawText(p,5,fnt.pixelSize()+5,fpsT);
@@ -773,7 +782,7 @@ void MainWindow::loadGame(std::string_view slot) {
 
   Gothic::inst().startLoad("LOADING.TGA",[slot=std::string(slot)](std::unique_ptr<GameSession>&& game){
     game = nullptr; // clear world-memory now
-    Tempest::RFile file(slot);
+    SaveReader     file(slot);
     Serialize      s(file);
     std::unique_ptr<GameSession> w(new GameSession(s));
     return w;
@@ -790,9 +799,14 @@ void MainWindow::saveGame(std::string_view slot, std::string_view name) {
     if(!game)
       return std::move(game);
 
-    Tempest::WFile f(slot);
-    Serialize      s(f);
-    game->save(s,name.c_str(),pm);
+    // snapshot game state in memory; compression and disk i/o are done in background
+    std::vector<uint8_t> data;
+    {
+      Tempest::MemWriter wr{data};
+      Serialize          s(wr);
+      game->save(s,name.c_str(),pm);
+    }
+    SaveWriter::write(slot,std::move(data));
 
     // no print yet, because threading
     // gothic.print("Game saved");
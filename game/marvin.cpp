@@ -4,6 +4,7 @@
 #include <cstdint>
 
 #include "world/objects/npc.h"
+#include "graphics/mesh/packedsamples.h"
 #include "camera.h"
 #include "gothic.h"
 
@@ -85,6 +86,8 @@ Marvin::Marvin() {
     {"toogle camdebug",   C_ToogleCamDebug},
     {"toogle camera",     C_ToogleCamera},
     {"insert %c",         C_Insert},
+    {"bench groundray",   C_BenchGroundRay},
+    {"bench anisamples",  C_BenchAniSamples},
     };
   }
 
@@ -218,6 +221,30 @@ bool Marvin::exec(const std::string& v) {
         return false;
       return addItemOrNpcBySymbolName(world, ret.argv[0], player->position());
       }
+    case C_BenchGroundRay: {
+      World* world  = Gothic::inst().world();
+      Npc*   player = Gothic::inst().player();
+      if(world==nullptr || player==nullptr)
+        return false;
+      // 1024 down-casts in 100x100 meters around player
+      auto st = world->physic()->benchGroundRays(player->position(),5000.f,1024);
+      char buf[256] = {};
+      std::snprintf(buf,sizeof(buf),"rays = %u (grid %u): grid %.2fms, bvh %.2fms, mismatch %u; brute %u rays: %.2fms, mismatch %u",
+                    st.rays,st.gridRays,double(st.gridUs)/1000.0,double(st.bvhUs)/1000.0,st.bvhMismatch,
+                    st.bruteRays,double(st.bruteUs)/1000.0,st.bruteMismatch);
+      print(buf);
+      return true;
+      }
+    case C_BenchAniSamples: {
+      // synthetic 60-bone clip of 120 frames, 20000 frame decodes
+      auto st = PackedSamples::bench(60,120,20000);
+      char buf[256] = {};
+      std::snprintf(buf,sizeof(buf),"samples %ub x %uf: raw %zu bytes, packed %zu bytes; error rot %g, pos %g; raw %.2fms, packed %.2fms",
+                    st.tracks,st.frames,st.rawBytes,st.packedBytes,double(st.rotError),double(st.posError),
+                    double(st.rawUs)/1000.0,double(st.packedUs)/1000.0);
+      print(buf);
+      return true;
+      }
     case C_PrintVar: {
       World* world  = Gothic::inst().world();
       Npc*   player = Gothic::inst().player();
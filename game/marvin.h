@@ -32,6 +32,10 @@ class Marvin {
       C_CamMode,
       C_ToogleCamDebug,
       C_ToogleCamera,
+      // physics
+      C_BenchGroundRay,
+      // animation
+      C_BenchAniSamples,
 
       C_Insert,
       };
@@ -8,12 +8,15 @@
 #include "graphics/mesh/skeleton.h"
 
 #include <algorithm>
+#include <chrono>
 #include <cmath>
+#include <unordered_map>
 
 #include "graphics/mesh/submesh/packedmesh.h"
 #include "world/objects/item.h"
 #include "world/bullet.h"
 #include "world/world.h"
+#include "utils/workers.h"
 
 const float DynamicWorld::ghostPadding=50-22.5f;
 const float DynamicWorld::ghostHeight =140;
@@ -43,8 +46,10 @@ struct DynamicWorld::NpcBody : btRigidBody {
   Tempest::Vec3 pos={};
   float         r=0, h=0, rX=0, rZ=0;
   bool          enable=true;
-  size_t        frozen=size_t(-1);
-  uint64_t      lastMove=0;
+  // location in NpcBodyList
+  size_t        id=size_t(-1);
+  uint64_t      cell=0;
+  size_t        slot=0;
 
   Npc* toNpc() {
     return reinterpret_cast<Npc*>(getUserPointer());
@@ -60,14 +65,13 @@ struct DynamicWorld::NpcBody : btRigidBody {
   };
 
 struct DynamicWorld::NpcBodyList final {
-  struct Record final {
-    NpcBody* body = nullptr;
-    float    x    = 0.f;
-    };
+  // uniform grid over XZ plane, cell size is in centimeters
+  static constexpr float CellSize = 256.f;
+  // ray-queries, that cover more cells than this, scan all bodies
+  static constexpr int   MaxRayCells = 64;
 
   NpcBodyList(DynamicWorld& wrld):wrld(wrld){
-    body  .reserve(1024);
-    frozen.reserve(1024);
+    body.reserve(1024);
     }
 
   NpcBody* create(const ZMath::float3 &min, const ZMath::float3 &max) {
@@ -95,44 +99,21 @@ struct DynamicWorld::NpcBodyList final {
     }
 
   void add(NpcBody* b){
-    Record r;
-    r.body = b;
-    r.x    = b->pos.x;
-    body.push_back(r);
-    }
-
-  bool del(void* b){
-    if(del(b,body))
-      return true;
-    if(del(b,frozen)){
-      srt=false;
-      return true;
-      }
-    return false;
-    }
-
-  bool del(void* b,std::vector<Record>& arr){
-    for(size_t i=0;i<arr.size();++i){
-      if(arr[i].body!=b)
-        continue;
-      arr[i]=arr.back();
-      arr.pop_back();
-      return true;
-      }
-    return false;
+    b->id = body.size();
+    body.push_back(b);
+    b->cell = cellKey(cellOf(b->pos.x),cellOf(b->pos.z));
+    attach(*b);
     }
 
-  bool delMisordered(NpcBody* b,std::vector<Record>& arr){
-    auto&       fr = arr[b->frozen];
-    const float x  = fr.x;
-    if((b->frozen==0 || arr[b->frozen-1].x<x) &&
-       (b->frozen+1==arr.size() || x<arr[b->frozen+1].x)) {
-      fr.x = fr.body->pos.x;
+  bool del(NpcBody* b){
+    if(b==nullptr || b->id>=body.size() || body[b->id]!=b)
       return false;
-      } else {
-      fr.body = nullptr;
-      return true;
-      }
+    detach(*b);
+    body[b->id]     = body.back();
+    body[b->id]->id = b->id;
+    body.pop_back();
+    b->id = size_t(-1);
+    return true;
     }
 
   void resize(NpcBody& n, float h, float dx, float dz){
@@ -147,18 +128,12 @@ struct DynamicWorld::NpcBodyList final {
     }
 
   void onMove(NpcBody& n){
-    if(n.frozen!=size_t(-1)) {
-      if(delMisordered(&n,frozen)){
-        n.lastMove = tick;
-        n.frozen   = size_t(-1);
-
-        Record r;
-        r.body = &n;
-        body.push_back(r);
-        }
-      } else {
-      n.lastMove = tick;
-      }
+    uint64_t key = cellKey(cellOf(n.pos.x),cellOf(n.pos.z));
+    if(key==n.cell || n.id==size_t(-1))
+      return;
+    detach(n);
+    n.cell = key;
+    attach(n);
     }
 
   bool rayTest(NpcBody& npc, const btVector3& s, const btVector3& e) {
@@ -188,12 +163,26 @@ struct DynamicWorld::NpcBodyList final {
     rayToTrans.setIdentity();
     rayToTrans.setOrigin(e);
 
-    for(auto i:body)
-      if(rayTestSingle(rayFromTrans, rayToTrans, *i.body, callback))
-        return i.body;
-    for(auto i:frozen)
-      if(i.body!=nullptr && rayTestSingle(rayFromTrans, rayToTrans, *i.body, callback))
-        return i.body;
+    // ray is in meters, grid is in centimeters
+    const float pad = maxR;
+    const int   x0  = cellOf(std::min(s.x(),e.x())*100.f-pad), x1 = cellOf(std::max(s.x(),e.x())*100.f+pad);
+    const int   z0  = cellOf(std::min(s.z(),e.z())*100.f-pad), z1 = cellOf(std::max(s.z(),e.z())*100.f+pad);
+    if(int64_t(x1-x0+1)*int64_t(z1-z0+1)>MaxRayCells) {
+      for(auto i:body)
+        if(rayTestSingle(rayFromTrans, rayToTrans, *i, callback))
+          return i;
+      return nullptr;
+      }
+
+    for(int x=x0; x<=x1; ++x)
+      for(int z=z0; z<=z1; ++z) {
+        auto c = cells.find(cellKey(x,z));
+        if(c==cells.end())
+          continue;
+        for(auto i:c->second)
+          if(rayTestSingle(rayFromTrans, rayToTrans, *i, callback))
+            return i;
+        }
     return nullptr;
     }
 
@@ -219,38 +208,20 @@ struct DynamicWorld::NpcBodyList final {
       return false;
     const NpcBody& n = *pn;
 
-    if(srt){
-      if(hasCollision(n,frozen,normal,true))
-        return true;
-      return hasCollision(n,body,normal,false);
-      } else {
-      if(hasCollision(n,body,normal,false))
-        return true;
-      //adjustSort();
-      return hasCollision(n,frozen,normal,false);
-      }
-    }
-
-  bool hasCollision(const NpcBody& n,const std::vector<Record>& arr,Tempest::Vec3& normal, bool sorted) {
-    auto l = arr.begin();
-    auto r = arr.end();
-
-    if(sorted) {
-      const float dX = maxR+n.r;
-      l = std::lower_bound(arr.begin(),arr.end(),n.pos.x-dX,[](const Record& b,float x){ return b.x<x; });
-      r = std::upper_bound(arr.begin(),arr.end(),n.pos.x+dX,[](float x,const Record& b){ return x<b.x; });
-      }
-
-    const auto dist = std::distance(l,r);
-    if(dist<=1)
-      return false;
+    const float R   = maxR+n.r;
+    const int   x0  = cellOf(n.pos.x-R), x1 = cellOf(n.pos.x+R);
+    const int   z0  = cellOf(n.pos.z-R), z1 = cellOf(n.pos.z+R);
 
     bool ret=false;
-    for(;l!=r;++l){
-      auto& v = (*l);
-      if(v.body!=nullptr && v.body->enable && hasCollision(n,*v.body,normal))
-        ret = true;
-      }
+    for(int x=x0; x<=x1; ++x)
+      for(int z=z0; z<=z1; ++z) {
+        auto c = cells.find(cellKey(x,z));
+        if(c==cells.end())
+          continue;
+        for(auto v:c->second)
+          if(v->enable && hasCollision(n,*v,normal))
+            ret = true;
+        }
     return ret;
     }
 
@@ -271,54 +242,47 @@ struct DynamicWorld::NpcBodyList final {
     return true;
     }
 
-  void adjustSort() {
-    srt=true;
-    std::sort(frozen.begin(),frozen.end(),[](Record& a,Record& b){
-      return a.x < b.x;
-      });
-    for(size_t i=0; i<frozen.size(); ++i)
-      frozen[i].body->frozen = i;
-    }
-
   void tickAabbs() {
-    for(size_t i=0;i<body.size();) {
-      if(body[i].body->lastMove!=tick){
-        auto b = body[i];
-        body[i]=body.back();
-        body.pop_back();
-
-        b.x = b.body->pos.x;
-        frozen.push_back(b);
-        } else {
-        ++i;
-        }
+    // empty cells are released with delay, to not reallocate them, when npc walks along the cell border
+    for(auto key:emptyCells) {
+      auto c = cells.find(key);
+      if(c!=cells.end() && c->second.empty())
+        cells.erase(c);
       }
+    emptyCells.clear();
+    }
 
-    for(size_t i=0;i<frozen.size();) {
-      if(frozen[i].body==nullptr) {
-        frozen[i]=frozen.back();
-        frozen.pop_back();
-        }
-      else if(frozen[i].body->lastMove==tick){
-        frozen[i].body->frozen=size_t(-1);
-        body.push_back(frozen[i]);
-        frozen[i]=frozen.back();
-        frozen.pop_back();
-        }
-      else {
-        ++i;
-        }
-      }
+  static int cellOf(float v) {
+    if(!std::isfinite(v))
+      return 0;
+    return int(std::floor(std::max(std::min(v/CellSize,1e6f),-1e6f)));
+    }
 
-    adjustSort();
-    tick++;
+  static uint64_t cellKey(int x, int z) {
+    return (uint64_t(uint32_t(x))<<32) | uint64_t(uint32_t(z));
     }
 
-  DynamicWorld&         wrld;
-  std::vector<Record>   body, frozen;
-  bool                  srt=false;
-  uint64_t              tick=0;
-  float                 maxR=0;
+  void attach(NpcBody& n) {
+    auto& c = cells[n.cell];
+    n.slot = c.size();
+    c.push_back(&n);
+    }
+
+  void detach(NpcBody& n) {
+    auto& c = cells[n.cell];
+    c[n.slot]       = c.back();
+    c[n.slot]->slot = n.slot;
+    c.pop_back();
+    if(c.empty())
+      emptyCells.push_back(n.cell);
+    }
+
+  DynamicWorld&                                      wrld;
+  // dense list of all bodies; NpcBody::id is index in this array
+  std::vector<NpcBody*>                              body;
+  std::unordered_map<uint64_t,std::vector<NpcBody*>> cells;
+  std::vector<uint64_t>                              emptyCells;
+  float                                              maxR=0;
   };
 
 struct DynamicWorld::BulletsList final {
@@ -416,38 +380,66 @@ DynamicWorld::DynamicWorld(World& owner,const ZenLoad::zCMesh& worldMesh) {
   //solver.reset(new btSequentialImpulseConstraintSolver());
   world.reset(new CollisionWorld());
 
-  PackedMesh pkg(worldMesh,PackedMesh::PK_PhysicZoned);
-  sectors.resize(pkg.subMeshes.size());
-  for(size_t i=0;i<sectors.size();++i)
-    sectors[i] = pkg.subMeshes[i].material.matName;
-
-  landVbo.resize(pkg.vertices.size());
-  for(size_t i=0;i<pkg.vertices.size();++i) {
-    auto p = CollisionWorld::toMeters(pkg.vertices[i].Position);
-    landVbo[i] = p;
+  // welded mesh and BVH are taken from cache, if world mesh is unchanged
+  const uint64_t                    hash      = PhysicCache::hashOf(worldMesh);
+  const std::string                 cachePath = owner.name()+".phy";
+  std::vector<PhysicCache::SubMesh> sub;
+  const bool                        cached    = bvhCache.load(cachePath,hash,landVbo,sub);
+  if(!cached) {
+    PackedMesh pkg(worldMesh,PackedMesh::PK_PhysicZoned);
+    landVbo.resize(pkg.vertices.size());
+    for(size_t i=0;i<pkg.vertices.size();++i) {
+      auto p = CollisionWorld::toMeters(pkg.vertices[i].Position);
+      landVbo[i] = p;
+      }
+    sub.resize(pkg.subMeshes.size());
+    for(size_t i=0;i<pkg.subMeshes.size();++i) {
+      auto& sm = pkg.subMeshes[i];
+      sub[i].sector   = sm.material.matName;
+      sub[i].matGroup = uint8_t(sm.material.matGroup);
+      sub[i].collide  = !sm.material.noCollDet && sm.indices.size()>0;
+      if(sub[i].collide)
+        sub[i].indices = std::move(sm.indices);
+      }
     }
 
+  sectors.resize(sub.size());
+  for(size_t i=0;i<sectors.size();++i)
+    sectors[i] = sub[i].sector;
+
   landMesh .reset(new PhysicVbo(&landVbo));
   waterMesh.reset(new PhysicVbo(&landVbo));
 
-  for(size_t i=0;i<pkg.subMeshes.size();++i) {
-    auto& sm = pkg.subMeshes[i];
-    if(!sm.material.noCollDet && sm.indices.size()>0) {
-      if(sm.material.matGroup==ZenLoad::MaterialGroup::WATER) {
-        waterMesh->addIndex(std::move(sm.indices),sm.material.matGroup);
-        } else {
-        landMesh ->addIndex(std::move(sm.indices),sm.material.matGroup,sectors[i].c_str());
-        }
+  for(size_t i=0;i<sub.size();++i) {
+    auto& sm = sub[i];
+    if(!sm.collide)
+      continue;
+    std::vector<uint32_t> index;
+    if(cached)
+      index = std::move(sm.indices); else
+      index = sm.indices; // still needed to write the cache
+    if(sm.matGroup==ZenLoad::MaterialGroup::WATER) {
+      waterMesh->addIndex(std::move(index),sm.matGroup);
+      } else {
+      landMesh ->addIndex(std::move(index),sm.matGroup,sectors[i].c_str());
       }
     }
 
+  btOptimizedBvh* landBvh  = nullptr;
+  btOptimizedBvh* waterBvh = nullptr;
+
   btVector3 bbox[2] = {};
   if(!landMesh->isEmpty()) {
     Tempest::Matrix4x4 mt;
     mt.identity();
-    landShape.reset(new btMultimaterialTriangleMeshShape(landMesh.get(),landMesh->useQuantization(),true));
+    auto shape = new btMultimaterialTriangleMeshShape(landMesh.get(),landMesh->useQuantization(),bvhCache.landBvh()==nullptr);
+    landShape.reset(shape);
+    if(bvhCache.landBvh()!=nullptr)
+      shape->setOptimizedBvh(bvhCache.landBvh());
+    landBvh  = shape->getOptimizedBvh();
     landBody = world->addCollisionBody(*landShape,mt,DynamicWorld::materialFriction(ZenLoad::NUM_MAT_GROUPS));
     landBody->setUserIndex(C_Landscape);
+    landGrid.build(*landMesh);
 
     btVector3 b[2] = {};
     landBody->getAabb(b[0],b[1]);
@@ -458,7 +450,11 @@ DynamicWorld::DynamicWorld(World& owner,const ZenLoad::zCMesh& worldMesh) {
   if(!waterMesh->isEmpty()) {
     Tempest::Matrix4x4 mt;
     mt.identity();
-    waterShape.reset(new btMultimaterialTriangleMeshShape(waterMesh.get(),waterMesh->useQuantization(),true));
+    auto shape = new btMultimaterialTriangleMeshShape(waterMesh.get(),waterMesh->useQuantization(),bvhCache.waterBvh()==nullptr);
+    waterShape.reset(shape);
+    if(bvhCache.waterBvh()!=nullptr)
+      shape->setOptimizedBvh(bvhCache.waterBvh());
+    waterBvh  = shape->getOptimizedBvh();
     waterBody = world->addCollisionBody(*waterShape,mt,0);
     waterBody->setUserIndex(C_Water);
     waterBody->setFlags(btCollisionObject::CF_STATIC_OBJECT | btCollisionObject::CF_NO_CONTACT_RESPONSE);
@@ -471,6 +467,8 @@ DynamicWorld::DynamicWorld(World& owner,const ZenLoad::zCMesh& worldMesh) {
     }
 
   world->setBBox(bbox[0],bbox[1]);
+  if(!cached)
+    PhysicCache::save(cachePath,hash,landVbo,sub,landBvh,waterBvh);
   npcList   .reset(new NpcBodyList(*this));
   bulletList.reset(new BulletsList(*this));
   bboxList  .reset(new BBoxList   (*this));
@@ -544,15 +542,103 @@ DynamicWorld::RayWaterResult DynamicWorld::implWaterRay(const Tempest::Vec3& fro
   }
 
 DynamicWorld::RayLandResult DynamicWorld::ray(const Tempest::Vec3& from, const Tempest::Vec3& to) const {
+  RayLandResult ret;
+  if(from.x==to.x && from.z==to.z && to.y<from.y && groundRay(from,to,ret))
+    return ret;
+  return implRay(from,to,true);
+  }
+
+bool DynamicWorld::groundRay(const Tempest::Vec3& from, const Tempest::Vec3& to, RayLandResult& out) const {
+  HeightGrid::Hit hit;
+  if(!landGrid.rayDown(from.x*0.01f,from.z*0.01f,from.y*0.01f,to.y*0.01f,hit))
+    return false;
+
+  // landscape is resolved by grid; objects above of the ground still need a ray-test
+  const Tempest::Vec3 ground = hit.hasCol ? Tempest::Vec3(to.x,hit.y*100.f,to.z) : to;
+  out = implRay(from,ground,false);
+  if(out.hasCol || !hit.hasCol)
+    return true;
+
+  const size_t segment = landMesh->segmentOf(hit.triangle);
+  out.v      = ground;
+  out.n      = hit.n;
+  out.mat    = landMesh->materialId(segment);
+  out.sector = landMesh->sectorName(segment);
+  out.hasCol = true;
+  return true;
+  }
+
+DynamicWorld::GroundRayStats DynamicWorld::benchGroundRays(const Tempest::Vec3& at, float radius, uint32_t count) const {
+  using Clock = std::chrono::steady_clock;
+  auto usSince = [](Clock::time_point t) {
+    return uint64_t(std::chrono::duration_cast<std::chrono::microseconds>(Clock::now()-t).count());
+    };
+
+  // deterministic points in square around 'at'
+  std::vector<Tempest::Vec3> from(count);
+  uint32_t seed = 12345;
+  for(auto& i:from) {
+    seed = seed*1664525u+1013904223u;
+    float u = float(seed>>8)/float(1u<<24);
+    seed = seed*1664525u+1013904223u;
+    float v = float(seed>>8)/float(1u<<24);
+    i = Tempest::Vec3(at.x+(u*2.f-1.f)*radius, at.y+500.f, at.z+(v*2.f-1.f)*radius);
+    }
+
+  world->updateAabbs();
+  GroundRayStats            st;
+  std::vector<RayLandResult> grid(count), bvh(count);
+  std::vector<uint8_t>       inGrid(count,0);
+  st.rays = count;
+
+  auto t = Clock::now();
+  for(size_t i=0; i<count; ++i) {
+    const Tempest::Vec3 to(from[i].x,from[i].y-worldHeight,from[i].z);
+    inGrid[i] = groundRay(from[i],to,grid[i]) ? 1 : 0;
+    if(!inGrid[i])
+      grid[i] = implRay(from[i],to,true);
+    }
+  st.gridUs = usSince(t);
+
+  t = Clock::now();
+  for(size_t i=0; i<count; ++i)
+    bvh[i] = implRay(from[i],Tempest::Vec3(from[i].x,from[i].y-worldHeight,from[i].z),true);
+  st.bvhUs = usSince(t);
+
+  for(size_t i=0; i<count; ++i) {
+    if(inGrid[i])
+      st.gridRays++;
+    if(grid[i].hasCol!=bvh[i].hasCol || (grid[i].hasCol && std::fabs(grid[i].v.y-bvh[i].v.y)>1.f))
+      st.bvhMismatch++;
+    }
+
+  // test of all triangles is slow: only first rays, that grid can resolve
+  t = Clock::now();
+  for(size_t i=0; i<count && st.bruteRays<GroundRayStats::maxBrute; ++i) {
+    const float     x  = from[i].x*0.01f, z = from[i].z*0.01f;
+    const float     y0 = from[i].y*0.01f, y1 = (from[i].y-worldHeight)*0.01f;
+    HeightGrid::Hit g, b;
+    if(!landGrid.rayDown(x,z,y0,y1,g) || !landGrid.rayDownBrute(x,z,y0,y1,b))
+      continue;
+    st.bruteRays++;
+    if(g.hasCol!=b.hasCol || (g.hasCol && std::fabs(g.y-b.y)>0.01f))
+      st.bruteMismatch++;
+    }
+  st.bruteUs = usSince(t);
+  return st;
+  }
+
+DynamicWorld::RayLandResult DynamicWorld::implRay(const Tempest::Vec3& from, const Tempest::Vec3& to, bool landscape) const {
   struct CallBack:btCollisionWorld::ClosestRayResultCallback {
     using ClosestRayResultCallback::ClosestRayResultCallback;
-    uint8_t     matId  = 0;
-    const char* sector = nullptr;
-    Category    colCat = C_Null;
+    uint8_t     matId     = 0;
+    const char* sector    = nullptr;
+    Category    colCat    = C_Null;
+    bool        landscape = true;
 
     bool needsCollision(btBroadphaseProxy* proxy0) const override {
       auto obj=reinterpret_cast<btCollisionObject*>(proxy0->m_clientObject);
-      if(obj->getUserIndex()==C_Landscape || obj->getUserIndex()==C_Object)
+      if((obj->getUserIndex()==C_Landscape && landscape) || obj->getUserIndex()==C_Object)
         return ClosestRayResultCallback::needsCollision(proxy0);
       return false;
       }
@@ -573,7 +659,8 @@ DynamicWorld::RayLandResult DynamicWorld::ray(const Tempest::Vec3& from, const T
     };
 
   CallBack callback{CollisionWorld::toMeters(from), CollisionWorld::toMeters(to)};
-  callback.m_flags = btTriangleRaycastCallback::kF_KeepUnflippedNormal | btTriangleRaycastCallback::kF_FilterBackfaces;
+  callback.m_flags   = btTriangleRaycastCallback::kF_KeepUnflippedNormal | btTriangleRaycastCallback::kF_FilterBackfaces;
+  callback.landscape = landscape;
 
   world->rayCast(from,to,callback);
 
@@ -641,6 +728,93 @@ float DynamicWorld::soundOclusion(const Tempest::Vec3& from, const Tempest::Vec3
   return (tlen*fr)/1.5f;
   }
 
+void DynamicWorld::rayBatch(RayBatch& rb) const {
+  const size_t cnt = rb.size();
+  rb.v     .resize(cnt);
+  rb.n     .resize(cnt);
+  rb.value .resize(cnt);
+  rb.mat   .resize(cnt);
+  rb.hasCol.resize(cnt);
+  rb.sector.resize(cnt);
+  if(cnt==0)
+    return;
+
+  // queries below do not modify world; broadphase ray-test stack is per thread
+  world->updateAabbs();
+  Workers::parallelRange(cnt,16,[this,&rb](size_t b, size_t e){
+    for(size_t i=b; i<e; ++i) {
+      switch(rb.filter[i]) {
+        case RayBatch::F_Land: {
+          auto r = ray(rb.from[i],rb.to[i]);
+          rb.v[i]      = r.v;
+          rb.n[i]      = r.n;
+          rb.mat[i]    = r.mat;
+          rb.hasCol[i] = r.hasCol ? 1 : 0;
+          rb.sector[i] = r.sector;
+          break;
+          }
+        case RayBatch::F_Water: {
+          auto r = implWaterRay(rb.from[i],rb.to[i]);
+          rb.value[i]  = r.wdepth;
+          rb.hasCol[i] = r.hasCol ? 1 : 0;
+          break;
+          }
+        case RayBatch::F_Sound:
+          rb.value[i] = soundOclusion(rb.from[i],rb.to[i]);
+          break;
+        }
+      }
+    });
+  }
+
+size_t DynamicWorld::RayBatch::addLand(const Tempest::Vec3& from, float maxDy) {
+  if(maxDy==0)
+    maxDy = worldHeight;
+  return push(Tempest::Vec3(from.x,from.y+ghostPadding,from.z), Tempest::Vec3(from.x,from.y-maxDy,from.z), F_Land);
+  }
+
+size_t DynamicWorld::RayBatch::addWater(const Tempest::Vec3& from) {
+  return push(from, Tempest::Vec3(from.x,from.y+worldHeight,from.z), F_Water);
+  }
+
+size_t DynamicWorld::RayBatch::addRay(const Tempest::Vec3& from, const Tempest::Vec3& to) {
+  return push(from,to,F_Land);
+  }
+
+size_t DynamicWorld::RayBatch::addSound(const Tempest::Vec3& from, const Tempest::Vec3& to) {
+  return push(from,to,F_Sound);
+  }
+
+void DynamicWorld::RayBatch::clear() {
+  from  .clear();
+  to    .clear();
+  filter.clear();
+  }
+
+size_t DynamicWorld::RayBatch::push(const Tempest::Vec3& f, const Tempest::Vec3& t, Filter flt) {
+  from  .push_back(f);
+  to    .push_back(t);
+  filter.push_back(flt);
+  return filter.size()-1;
+  }
+
+DynamicWorld::RayLandResult DynamicWorld::RayBatch::land(size_t i) const {
+  RayLandResult ret;
+  ret.v      = v[i];
+  ret.n      = n[i];
+  ret.mat    = mat[i];
+  ret.hasCol = hasCol[i]!=0;
+  ret.sector = sector[i];
+  return ret;
+  }
+
+DynamicWorld::RayWaterResult DynamicWorld::RayBatch::water(size_t i) const {
+  RayWaterResult ret;
+  ret.wdepth = value[i];
+  ret.hasCol = hasCol[i]!=0;
+  return ret;
+  }
+
 DynamicWorld::NpcItem DynamicWorld::ghostObj(std::string_view visual) {
   ZMath::float3 min={0,0,0}, max={0,0,0};
   if(auto sk=Resources::loadSkeleton(visual)) {
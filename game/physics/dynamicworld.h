@@ -6,6 +6,10 @@
 #include <Tempest/Matrix4x4>
 #include <memory>
 #include <limits>
+#include <vector>
+
+#include "physiccache.h"
+#include "heightgrid.h"
 
 class btTriangleIndexVertexArray;
 class btCollisionShape;
@@ -133,6 +137,53 @@ class DynamicWorld final {
       bool                hasCol = false;
       };
 
+    // structure of arrays for many ray-casts at once, see DynamicWorld::rayBatch
+    struct RayBatch {
+      enum Filter : uint8_t {
+        F_Land,   // closest landscape or static object, as ray()
+        F_Water,  // water surface above of 'from', as waterRay()
+        F_Sound,  // occlusion factor, as soundOclusion()
+        };
+
+      size_t              addLand (const Tempest::Vec3& from, float maxDy=0);
+      size_t              addWater(const Tempest::Vec3& from);
+      size_t              addRay  (const Tempest::Vec3& from, const Tempest::Vec3& to);
+      size_t              addSound(const Tempest::Vec3& from, const Tempest::Vec3& to);
+      void                clear();
+
+      size_t              size()          const { return filter.size(); }
+      RayLandResult       land (size_t i) const;
+      RayWaterResult      water(size_t i) const;
+      float               occlusion(size_t i) const { return value[i]; }
+
+      // input
+      std::vector<Tempest::Vec3> from, to;
+      std::vector<Filter>        filter;
+      // output
+      std::vector<Tempest::Vec3> v, n;
+      std::vector<float>         value; // water depth or occlusion
+      std::vector<uint8_t>       mat;
+      std::vector<uint8_t>       hasCol;
+      std::vector<const char*>   sector;
+
+      private:
+        size_t            push(const Tempest::Vec3& from, const Tempest::Vec3& to, Filter f);
+      };
+
+    // debug: comparison of height-grid down-casts against BVH and against test of all triangles
+    struct GroundRayStats {
+      static constexpr uint32_t maxBrute = 128;
+
+      uint32_t            rays          = 0;
+      uint32_t            gridRays      = 0; // resolved by grid, rest did fall back to BVH
+      uint32_t            bvhMismatch   = 0;
+      uint32_t            bruteRays     = 0;
+      uint32_t            bruteMismatch = 0;
+      uint64_t            gridUs        = 0;
+      uint64_t            bvhUs         = 0;
+      uint64_t            bruteUs       = 0;
+      };
+
     struct BulletCallback {
       virtual ~BulletCallback()=default;
       virtual void onStop(){}
@@ -211,6 +262,9 @@ class DynamicWorld final {
 
     RayLandResult  ray          (const Tempest::Vec3& from, const Tempest::Vec3& to) const;
     float          soundOclusion(const Tempest::Vec3& from, const Tempest::Vec3& to) const;
+    // resolves all rays in parallel; world must not be modified meanwhile
+    void           rayBatch     (RayBatch& rb) const;
+    GroundRayStats benchGroundRays(const Tempest::Vec3& at, float radius, uint32_t count) const;
 
     NpcItem        ghostObj  (std::string_view visual);
     Item           staticObj (const PhysicMeshShape *src, const Tempest::Matrix4x4& m);
@@ -242,14 +296,19 @@ class DynamicWorld final {
 
     void           moveBullet(BulletBody& b, const Tempest::Vec3& dir, uint64_t dt);
     RayWaterResult implWaterRay(const Tempest::Vec3& from, const Tempest::Vec3& to) const;
+    RayLandResult  implRay     (const Tempest::Vec3& from, const Tempest::Vec3& to, bool landscape) const;
+    bool           groundRay   (const Tempest::Vec3& from, const Tempest::Vec3& to, RayLandResult& out) const;
     bool           hasCollision(const NpcItem &it, CollisionTest& out);
 
     std::unique_ptr<CollisionWorld>    world;
 
     std::vector<std::string>           sectors;
+    // must outlive collision shapes: cached BVH lives in mapped memory
+    PhysicCache                        bvhCache;
 
     std::vector<btVector3>             landVbo;
     std::unique_ptr<PhysicVbo>         landMesh;
+    HeightGrid                         landGrid;
     std::unique_ptr<btCollisionShape>  landShape;
     std::unique_ptr<btRigidBody>       landBody;
 
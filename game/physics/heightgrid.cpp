@@ -0,0 +1,196 @@
+#include "heightgrid.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "physicvbo.h"
+#include "utils/workers.h"
+
+// in meters
+static const float    CellSize = 4.f;
+// more triangles in a cell than this: use BVH
+static const uint32_t MaxSpans = 32;
+static const uint64_t MaxCells = 16*1024*1024;
+
+static float normalY(const btVector3& a, const btVector3& b, const btVector3& c) {
+  // y component of (b-a)x(c-a); bullet filters back faces, so only these can be hit by down-cast
+  return (b.z()-a.z())*(c.x()-a.x()) - (b.x()-a.x())*(c.z()-a.z());
+  }
+
+static float edge(const btVector3& p, const btVector3& q, float x, float z) {
+  return (q.z()-p.z())*(x-p.x()) - (q.x()-p.x())*(z-p.z());
+  }
+
+void HeightGrid::build(const PhysicVbo& m) {
+  mesh = &m;
+  w    = 0;
+  h    = 0;
+  start.clear();
+  spans.clear();
+  fallback.clear();
+
+  auto&        vert   = m.vertices();
+  const size_t triCnt = m.triangleCount();
+
+  float bbox[4] = {std::numeric_limits<float>::max(), std::numeric_limits<float>::max(),
+                   std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest()};
+  for(size_t i=0; i<triCnt; ++i) {
+    auto t = m.triangle(i);
+    if(normalY(vert[t[0]],vert[t[1]],vert[t[2]])<=0)
+      continue;
+    for(size_t r=0; r<3; ++r) {
+      auto& v = vert[t[r]];
+      bbox[0] = std::min(bbox[0],v.x());
+      bbox[1] = std::min(bbox[1],v.z());
+      bbox[2] = std::max(bbox[2],v.x());
+      bbox[3] = std::max(bbox[3],v.z());
+      }
+    }
+  if(bbox[0]>bbox[2])
+    return;
+
+  const uint64_t cw = uint64_t((bbox[2]-bbox[0])/CellSize)+1;
+  const uint64_t ch = uint64_t((bbox[3]-bbox[1])/CellSize)+1;
+  if(cw*ch>MaxCells)
+    return;
+  minX = bbox[0];
+  minZ = bbox[1];
+  w    = uint32_t(cw);
+  h    = uint32_t(ch);
+
+  auto range = [&](const uint32_t* t, uint32_t* r) {
+    float x0 = vert[t[0]].x(), x1 = x0, z0 = vert[t[0]].z(), z1 = z0;
+    for(size_t i=1; i<3; ++i) {
+      x0 = std::min(x0,vert[t[i]].x());
+      x1 = std::max(x1,vert[t[i]].x());
+      z0 = std::min(z0,vert[t[i]].z());
+      z1 = std::max(z1,vert[t[i]].z());
+      }
+    // same rounding, as in cellOf
+    r[0] = uint32_t((x0-minX)/CellSize);
+    r[1] = uint32_t((z0-minZ)/CellSize);
+    r[2] = std::min(uint32_t((x1-minX)/CellSize),w-1);
+    r[3] = std::min(uint32_t((z1-minZ)/CellSize),h-1);
+    };
+
+  const size_t          cells = size_t(w)*h;
+  std::vector<uint32_t> count(cells,0);
+  for(size_t i=0; i<triCnt; ++i) {
+    auto t = m.triangle(i);
+    if(normalY(vert[t[0]],vert[t[1]],vert[t[2]])<=0)
+      continue;
+    uint32_t r[4] = {};
+    range(t,r);
+    for(uint32_t z=r[1]; z<=r[3]; ++z)
+      for(uint32_t x=r[0]; x<=r[2]; ++x)
+        count[z*w+x]++;
+    }
+
+  fallback.resize(cells);
+  start.resize(cells+1);
+  uint32_t total = 0;
+  for(size_t i=0; i<cells; ++i) {
+    start[i] = total;
+    if(count[i]>MaxSpans)
+      fallback[i] = true; else
+      total += count[i];
+    }
+  start[cells] = total;
+  spans.resize(total);
+
+  for(size_t i=0; i<triCnt; ++i) {
+    auto t = m.triangle(i);
+    if(normalY(vert[t[0]],vert[t[1]],vert[t[2]])<=0)
+      continue;
+    Span s;
+    s.yMin = std::min({vert[t[0]].y(),vert[t[1]].y(),vert[t[2]].y()});
+    s.yMax = std::max({vert[t[0]].y(),vert[t[1]].y(),vert[t[2]].y()});
+    s.tri  = uint32_t(i);
+
+    uint32_t r[4] = {};
+    range(t,r);
+    for(uint32_t z=r[1]; z<=r[3]; ++z)
+      for(uint32_t x=r[0]; x<=r[2]; ++x) {
+        size_t id = z*w+x;
+        if(fallback[id])
+          continue;
+        // count is reused as fill cursor
+        count[id]--;
+        spans[start[id]+count[id]] = s;
+        }
+    }
+
+  // top-most first: down-cast can stop, once span is below of the best hit
+  Workers::parallelRange(cells,1024,[this](size_t b, size_t e){
+    for(size_t i=b; i<e; ++i)
+      std::sort(spans.begin()+start[i],spans.begin()+start[i+1],[](const Span& l, const Span& r){
+        return l.yMax>r.yMax;
+        });
+    });
+  }
+
+bool HeightGrid::rayDown(float x, float z, float y0, float y1, Hit& out) const {
+  size_t id = 0;
+  if(!cellOf(x,z,id) || fallback[id])
+    return false;
+
+  float best = y1;
+  out = Hit();
+  for(uint32_t i=start[id]; i<start[id+1]; ++i) {
+    auto& s = spans[i];
+    if(s.yMax<best)
+      break;
+    if(s.yMin>y0)
+      continue;
+    hitTriangle(s.tri,x,z,y0,best,out);
+    }
+  return true;
+  }
+
+bool HeightGrid::rayDownBrute(float x, float z, float y0, float y1, Hit& out) const {
+  if(mesh==nullptr)
+    return false;
+  float best = y1;
+  out = Hit();
+  for(size_t i=0, cnt=mesh->triangleCount(); i<cnt; ++i)
+    hitTriangle(uint32_t(i),x,z,y0,best,out);
+  return true;
+  }
+
+bool HeightGrid::hitTriangle(uint32_t tri, float x, float z, float y0, float& best, Hit& out) const {
+  auto& vert = mesh->vertices();
+  auto  t    = mesh->triangle(tri);
+  auto& a    = vert[t[0]];
+  auto& b    = vert[t[1]];
+  auto& c    = vert[t[2]];
+  if(normalY(a,b,c)<=0)
+    return false;
+  if(edge(a,b,x,z)<0 || edge(b,c,x,z)<0 || edge(c,a,x,z)<0)
+    return false;
+
+  const btVector3 n = (b-a).cross(c-a);
+  const float     y = a.y() - (n.x()*(x-a.x()) + n.z()*(z-a.z()))/n.y();
+  if(y>y0 || y<best)
+    return false;
+
+  const float l = n.length();
+  best         = y;
+  out.y        = y;
+  out.n        = Tempest::Vec3(n.x()/l, n.y()/l, n.z()/l);
+  out.triangle = tri;
+  out.hasCol   = true;
+  return true;
+  }
+
+bool HeightGrid::cellOf(float x, float z, size_t& id) const {
+  const float fx = (x-minX)/CellSize;
+  const float fz = (z-minZ)/CellSize;
+  // also rejects NaN
+  if(!(fx>=0 && fx<float(w) && fz>=0 && fz<float(h)))
+    return false;
+  const uint32_t cx = std::min(uint32_t(fx),w-1);
+  const uint32_t cz = std::min(uint32_t(fz),h-1);
+  id = size_t(cz)*w+cx;
+  return true;
+  }
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <Tempest/Point>
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+class PhysicVbo;
+
+// 2.5D acceleration grid over landscape mesh, for vertical down-casts (ground snapping).
+// Each XZ cell holds front-facing triangles, that overlap the cell, sorted by height.
+// Cells with many layers (caves, overhangs, dense geometry) are not stored - BVH is used for them.
+class HeightGrid final {
+  public:
+    struct Hit {
+      Tempest::Vec3 n        = {};
+      float         y        = 0;
+      size_t        triangle = 0;
+      bool          hasCol   = false;
+      };
+
+    void  build(const PhysicVbo& mesh);
+    // ray from y0 down to y1 at (x,z), in meters; returns false, if BVH must be used instead
+    bool  rayDown(float x, float z, float y0, float y1, Hit& out) const;
+    // reference: tests all triangles of mesh; for validation of grid only
+    bool  rayDownBrute(float x, float z, float y0, float y1, Hit& out) const;
+
+  private:
+    struct Span {
+      float    yMin = 0;
+      float    yMax = 0;
+      uint32_t tri  = 0;
+      };
+
+    bool  cellOf(float x, float z, size_t& id) const;
+    bool  hitTriangle(uint32_t tri, float x, float z, float y0, float& best, Hit& out) const;
+
+    const PhysicVbo*      mesh = nullptr;
+    float                 minX = 0, minZ = 0;
+    uint32_t              w = 0, h = 0;
+    // spans of cell i are [start[i],start[i+1])
+    std::vector<uint32_t> start;
+    std::vector<Span>     spans;
+    std::vector<bool>     fallback;
+  };
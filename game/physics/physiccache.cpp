@@ -0,0 +1,184 @@
+#include "physiccache.h"
+
+#include <Tempest/WFile>
+#include <Tempest/Log>
+
+#include <cstring>
+#include <system_error>
+
+#include "physics.h"
+
+static const char     tag[]        = "OpenGothic/Phys";
+// increment, when mesh packing or file layout changes
+static const uint32_t CacheVersion = 1;
+
+struct PhysicCache::Header {
+  char     tag[sizeof(::tag)] = {};
+  uint32_t version     = 0;
+  // in-place BVH depends on pointer size and bullet build
+  uint32_t ptrSize     = 0;
+  uint32_t bvhSize     = 0;
+  uint32_t vertCount   = 0;
+  uint64_t hash        = 0;
+  uint32_t subCount    = 0;
+  uint32_t padding     = 0;
+  uint64_t landOffset  = 0;
+  uint64_t landSize    = 0;
+  uint64_t waterOffset = 0;
+  uint64_t waterSize   = 0;
+  };
+
+static uint64_t hashBytes(uint64_t h, const void* data, size_t size) {
+  auto   p = reinterpret_cast<const uint8_t*>(data);
+  size_t i = 0;
+  for(; i+8<=size; i+=8) {
+    uint64_t v = 0;
+    std::memcpy(&v,p+i,8);
+    h = (h^v)*0x100000001b3ull;
+    h ^= (h>>32);
+    }
+  for(; i<size; ++i)
+    h = (h^p[i])*0x100000001b3ull;
+  return (h^size)*0x100000001b3ull;
+  }
+
+template<class T>
+static uint64_t hashVec(uint64_t h, const std::vector<T>& v) {
+  return hashBytes(h,v.data(),v.size()*sizeof(T));
+  }
+
+static void append(std::vector<uint8_t>& buf, const void* data, size_t size) {
+  auto p = reinterpret_cast<const uint8_t*>(data);
+  buf.insert(buf.end(),p,p+size);
+  }
+
+static uint64_t appendBvh(std::vector<uint8_t>& buf, const btOptimizedBvh* bvh, uint64_t& size) {
+  size = 0;
+  if(bvh==nullptr)
+    return 0;
+  const unsigned sz  = bvh->calculateSerializeBufferSize();
+  void*          tmp = btAlignedAlloc(sz,16);
+  if(!bvh->serializeInPlace(tmp,sz,false)) {
+    btAlignedFree(tmp);
+    return 0;
+    }
+  // mapping is page aligned, BVH must be 16-byte aligned in file
+  buf.resize((buf.size()+15)/16*16);
+  const uint64_t at = buf.size();
+  append(buf,tmp,sz);
+  btAlignedFree(tmp);
+  size = sz;
+  return at;
+  }
+
+uint64_t PhysicCache::hashOf(const ZenLoad::zCMesh& mesh) {
+  uint64_t h = 0xcbf29ce484222325ull;
+  h = hashVec(h,mesh.getVertices());
+  h = hashVec(h,mesh.getIndices());
+  h = hashVec(h,mesh.getTriangleMaterialIndices());
+  for(auto& m:mesh.getMaterials()) {
+    const uint8_t flags[2] = {uint8_t(m.matGroup), uint8_t(m.noCollDet ? 1 : 0)};
+    h = hashBytes(h,m.matName.data(),m.matName.size());
+    h = hashBytes(h,flags,sizeof(flags));
+    }
+  return h;
+  }
+
+bool PhysicCache::load(const std::string& path, uint64_t hash,
+                       std::vector<btVector3>& vbo, std::vector<SubMesh>& sub) {
+  file = MappedFile::open(path);
+
+  Header hdr;
+  if(file.size()<sizeof(hdr))
+    return false;
+  std::memcpy(&hdr,file.data(),sizeof(hdr));
+  if(std::memcmp(hdr.tag,tag,sizeof(tag))!=0 ||
+     hdr.version!=CacheVersion || hdr.ptrSize!=sizeof(void*) || hdr.bvhSize!=sizeof(btOptimizedBvh) ||
+     hdr.hash!=hash) {
+    file = MappedFile();
+    return false;
+    }
+
+  size_t at   = sizeof(hdr);
+  auto   read = [this,&at](void* dest, size_t size) {
+    if(file.size()-at<size)
+      return false;
+    std::memcpy(dest,file.data()+at,size);
+    at += size;
+    return true;
+    };
+
+  bool ok = true;
+  vbo.resize(hdr.vertCount);
+  ok &= read(vbo.data(),vbo.size()*sizeof(btVector3));
+
+  sub.resize(hdr.subCount);
+  for(auto& s:sub) {
+    uint32_t info[4] = {};
+    if(!(ok &= read(info,sizeof(info))))
+      break;
+    s.matGroup = uint8_t(info[0]);
+    s.collide  = info[1]!=0;
+    s.sector.resize(info[2]);
+    s.indices.resize(info[3]);
+    ok &= read(&s.sector[0],s.sector.size());
+    ok &= read(s.indices.data(),s.indices.size()*sizeof(uint32_t));
+    }
+
+  if(ok && hdr.landSize>0)
+    ok &= (land = mapBvh(hdr.landOffset,hdr.landSize))!=nullptr;
+  if(ok && hdr.waterSize>0)
+    ok &= (water = mapBvh(hdr.waterOffset,hdr.waterSize))!=nullptr;
+
+  if(!ok) {
+    Tempest::Log::e("physic cache is corrupted: \"",path,"\"");
+    vbo.clear();
+    sub.clear();
+    land  = nullptr;
+    water = nullptr;
+    file  = MappedFile();
+    }
+  return ok;
+  }
+
+void PhysicCache::save(const std::string& path, uint64_t hash,
+                       const std::vector<btVector3>& vbo, const std::vector<SubMesh>& sub,
+                       const btOptimizedBvh* land, const btOptimizedBvh* water) {
+  Header hdr;
+  std::memcpy(hdr.tag,tag,sizeof(tag));
+  hdr.version   = CacheVersion;
+  hdr.ptrSize   = sizeof(void*);
+  hdr.bvhSize   = sizeof(btOptimizedBvh);
+  hdr.vertCount = uint32_t(vbo.size());
+  hdr.hash      = hash;
+  hdr.subCount  = uint32_t(sub.size());
+
+  std::vector<uint8_t> buf(sizeof(hdr));
+  append(buf,vbo.data(),vbo.size()*sizeof(btVector3));
+  for(auto& s:sub) {
+    const uint32_t info[4] = {s.matGroup, s.collide ? 1u : 0u, uint32_t(s.sector.size()), uint32_t(s.indices.size())};
+    append(buf,info,sizeof(info));
+    append(buf,s.sector.data(),s.sector.size());
+    append(buf,s.indices.data(),s.indices.size()*sizeof(uint32_t));
+    }
+  hdr.landOffset  = appendBvh(buf,land, hdr.landSize);
+  hdr.waterOffset = appendBvh(buf,water,hdr.waterSize);
+  if((land!=nullptr && hdr.landSize==0) || (water!=nullptr && hdr.waterSize==0))
+    return;
+  std::memcpy(buf.data(),&hdr,sizeof(hdr));
+
+  try {
+    Tempest::WFile fout(path);
+    if(fout.write(buf.data(),buf.size())!=buf.size())
+      Tempest::Log::e("unable to write physic cache: \"",path,"\"");
+    }
+  catch(std::system_error&) {
+    Tempest::Log::e("unable to write physic cache: \"",path,"\"");
+    }
+  }
+
+btOptimizedBvh* PhysicCache::mapBvh(uint64_t offset, uint64_t size) {
+  if(offset%16!=0 || offset>file.size() || size>file.size()-offset)
+    return nullptr;
+  return btOptimizedBvh::deSerializeInPlace(file.data()+offset,unsigned(size),false);
+  }
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <zenload/zCMesh.h>
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "utils/mappedfile.h"
+
+class btVector3;
+class btOptimizedBvh;
+
+// On-disk cache of welded landscape collision mesh together with prebuilt BVH trees.
+// BVH trees are used in-place from mapped file
+class PhysicCache final {
+  public:
+    struct SubMesh {
+      std::string           sector;
+      uint8_t               matGroup = 0;
+      bool                  collide  = false;
+      std::vector<uint32_t> indices;
+      };
+
+    static uint64_t  hashOf(const ZenLoad::zCMesh& mesh);
+
+    // returns false, if cache is missing or outdated
+    bool             load(const std::string& path, uint64_t hash,
+                          std::vector<btVector3>& vbo, std::vector<SubMesh>& sub);
+    static void      save(const std::string& path, uint64_t hash,
+                          const std::vector<btVector3>& vbo, const std::vector<SubMesh>& sub,
+                          const btOptimizedBvh* land, const btOptimizedBvh* water);
+
+    btOptimizedBvh*  landBvh()  const { return land;  }
+    btOptimizedBvh*  waterBvh() const { return water; }
+
+  private:
+    struct Header;
+
+    MappedFile       file;
+    btOptimizedBvh*  land  = nullptr;
+    btOptimizedBvh*  water = nullptr;
+
+    btOptimizedBvh*  mapBvh(uint64_t offset, uint64_t size);
+  };
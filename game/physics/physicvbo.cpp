@@ -2,6 +2,8 @@
 
 #include "collisionworld.h"
 
+#include <algorithm>
+
 PhysicVbo::PhysicVbo(ZenLoad::PackedMesh&& sPacked)
   :PhysicVbo(sPacked.vertices) {
   id = std::move(sPacked.indices);
@@ -88,6 +90,14 @@ const char* PhysicVbo::sectorName(size_t segment) const {
   return nullptr;
   }
 
+size_t PhysicVbo::segmentOf(size_t triangle) const {
+  const size_t at = triangle*3;
+  auto it = std::upper_bound(segments.begin(),segments.end(),at,[](size_t v, const Segment& s){
+    return v<s.off;
+    });
+  return size_t(std::distance(segments.begin(),it))-1;
+  }
+
 bool PhysicVbo::useQuantization() const {
   return segments.size()<1024;
   }
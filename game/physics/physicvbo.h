@@ -22,6 +22,12 @@ class PhysicVbo : public btTriangleIndexVertexArray {
     bool    useQuantization() const;
     bool    isEmpty() const;
 
+    // triangles of all segments are stored sequentially
+    size_t          triangleCount()            const { return id.size()/3; }
+    const uint32_t* triangle(size_t i)         const { return &id[i*3]; }
+    size_t          segmentOf(size_t triangle) const;
+    auto            vertices()                 const -> const std::vector<btVector3>& { return vert; }
+
     void    adjustMesh();
 
     const char* validateSectorName(const char* name) const;
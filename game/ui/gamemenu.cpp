@@ -13,6 +13,7 @@
 #include "utils/keycodec.h"
 #include "game/definitions/musicdefinitions.h"
 #include "game/serialize.h"
+#include "game/savefile.h"
 #include "game/savegameheader.h"
 #include "gothic.h"
 #include "resources.h"
@@ -619,8 +620,8 @@ void GameMenu::updateSavTitle(GameMenu::Item& sel) {
 
   SaveGameHeader hdr;
   try {
-    RFile     fin(fname);
-    Serialize reader(fin);
+    SaveReader fin(fname);
+    Serialize  reader(fin);
     reader.read(hdr);
     sel.handle.text[0] = hdr.name.c_str();
     sel.savHdr         = std::move(hdr);
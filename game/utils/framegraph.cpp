@@ -0,0 +1,13 @@
+#include "framegraph.h"
+
+FrameGraph::Id FrameGraph::stage(const char* name, uint64_t read, uint64_t write, std::function<void()> fn) {
+  Id id = graph.add(std::move(fn));
+  for(size_t i=0; i<stages.size(); ++i) {
+    auto& s = stages[i];
+    // read-after-write, write-after-read and write-after-write hazards
+    if((read & s.write)!=0 || (write & (s.read | s.write))!=0)
+      graph.depend(id,i);
+    }
+  stages.push_back(Stage{name,read,write});
+  return id;
+  }
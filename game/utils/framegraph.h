@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "workers.h"
+
+// Set of per-frame stages with declared resource access.
+// Stages are ordered by declaration, unless their read/write sets do not overlap -
+// then they are executed concurrently on Workers.
+class FrameGraph final {
+  public:
+    using Id = Workers::TaskGraph::Id;
+
+    FrameGraph() = default;
+    FrameGraph(const FrameGraph&) = delete;
+
+    Id   stage(const char* name, uint64_t read, uint64_t write, std::function<void()> fn);
+
+    void start() { graph.start(); }
+    void wait()  { graph.wait();  }
+    void run()   { graph.run();   }
+
+  private:
+    struct Stage {
+      const char* name  = nullptr;
+      uint64_t    read  = 0;
+      uint64_t    write = 0;
+      };
+
+    std::vector<Stage> stages;
+    Workers::TaskGraph graph;
+  };
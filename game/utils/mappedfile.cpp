@@ -0,0 +1,176 @@
+#include "mappedfile.h"
+
+#include <Tempest/Platform>
+#include <Tempest/TextCodec>
+
+#include <utility>
+
+#ifdef __WINDOWS__
+#include <windows.h>
+#else
+#include <cstdio>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+  :ptr(other.ptr), sz(other.sz), file(other.file), mapping(other.mapping) {
+  other.ptr     = nullptr;
+  other.sz      = 0;
+  other.file    = -1;
+  other.mapping = -1;
+  }
+
+MappedFile& MappedFile::operator = (MappedFile&& other) noexcept {
+  std::swap(ptr,    other.ptr);
+  std::swap(sz,     other.sz);
+  std::swap(file,   other.file);
+  std::swap(mapping,other.mapping);
+  return *this;
+  }
+
+MappedFile::~MappedFile() {
+  release();
+  }
+
+#ifdef __WINDOWS__
+MappedFile MappedFile::spill(const void* data, size_t size) {
+  MappedFile ret;
+  if(size==0)
+    return ret;
+
+  WCHAR dir[MAX_PATH+1] = {}, path[MAX_PATH+1] = {};
+  if(GetTempPathW(MAX_PATH,dir)==0 || GetTempFileNameW(dir,L"ogw",0,path)==0)
+    return ret;
+
+  // file is removed by OS, once last handle is closed
+  HANDLE f = CreateFileW(path, GENERIC_READ|GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS,
+                         FILE_ATTRIBUTE_TEMPORARY|FILE_FLAG_DELETE_ON_CLOSE, nullptr);
+  if(f==INVALID_HANDLE_VALUE)
+    return ret;
+  ret.file = intptr_t(f);
+
+  auto src = reinterpret_cast<const uint8_t*>(data);
+  for(size_t at=0; at<size;) {
+    DWORD chunk = DWORD(size-at<(1u<<30) ? size-at : (1u<<30));
+    DWORD wr    = 0;
+    if(!WriteFile(f,src+at,chunk,&wr,nullptr) || wr==0)
+      return MappedFile();
+    at += wr;
+    }
+
+  HANDLE m = CreateFileMappingW(f, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if(m==nullptr)
+    return MappedFile();
+  ret.mapping = intptr_t(m);
+
+  void* view = MapViewOfFile(m, FILE_MAP_READ, 0, 0, size);
+  if(view==nullptr)
+    return MappedFile();
+  ret.ptr = reinterpret_cast<uint8_t*>(view);
+  ret.sz  = size;
+  return ret;
+  }
+
+MappedFile MappedFile::open(const std::string& path) {
+  MappedFile ret;
+  auto   path16 = Tempest::TextCodec::toUtf16(path);
+  HANDLE f      = CreateFileW(reinterpret_cast<const WCHAR*>(path16.c_str()), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if(f==INVALID_HANDLE_VALUE)
+    return ret;
+  ret.file = intptr_t(f);
+
+  LARGE_INTEGER size = {};
+  if(!GetFileSizeEx(f,&size) || size.QuadPart<=0)
+    return MappedFile();
+
+  HANDLE m = CreateFileMappingW(f, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+  if(m==nullptr)
+    return MappedFile();
+  ret.mapping = intptr_t(m);
+
+  void* view = MapViewOfFile(m, FILE_MAP_COPY, 0, 0, 0);
+  if(view==nullptr)
+    return MappedFile();
+  ret.ptr = reinterpret_cast<uint8_t*>(view);
+  ret.sz  = size_t(size.QuadPart);
+  return ret;
+  }
+
+void MappedFile::release() {
+  if(ptr!=nullptr)
+    UnmapViewOfFile(ptr);
+  if(mapping!=-1)
+    CloseHandle(HANDLE(mapping));
+  if(file!=-1)
+    CloseHandle(HANDLE(file));
+  ptr     = nullptr;
+  sz      = 0;
+  file    = -1;
+  mapping = -1;
+  }
+#else
+MappedFile MappedFile::spill(const void* data, size_t size) {
+  MappedFile ret;
+  if(size==0)
+    return ret;
+
+  // tmpfile is unlinked already; space is reclaimed, once descriptor is closed
+  std::FILE* f = std::tmpfile();
+  if(f==nullptr)
+    return ret;
+  ret.file = dup(fileno(f));
+  std::fclose(f);
+  if(ret.file<0)
+    return MappedFile();
+
+  const int fd  = int(ret.file);
+  auto      src = reinterpret_cast<const uint8_t*>(data);
+  for(size_t at=0; at<size;) {
+    ssize_t wr = ::write(fd,src+at,size-at);
+    if(wr<=0)
+      return MappedFile();
+    at += size_t(wr);
+    }
+
+  void* view = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+  if(view==MAP_FAILED)
+    return MappedFile();
+  ret.ptr = reinterpret_cast<uint8_t*>(view);
+  ret.sz  = size;
+  return ret;
+  }
+
+MappedFile MappedFile::open(const std::string& path) {
+  MappedFile ret;
+  ret.file = ::open(path.c_str(),O_RDONLY);
+  if(ret.file<0)
+    return MappedFile();
+
+  struct stat st = {};
+  if(fstat(int(ret.file),&st)!=0 || st.st_size<=0)
+    return MappedFile();
+
+  const size_t size = size_t(st.st_size);
+  void*        view = mmap(nullptr, size, PROT_READ|PROT_WRITE, MAP_PRIVATE, int(ret.file), 0);
+  if(view==MAP_FAILED)
+    return MappedFile();
+  ret.ptr = reinterpret_cast<uint8_t*>(view);
+  ret.sz  = size;
+  return ret;
+  }
+
+void MappedFile::release() {
+  if(ptr!=nullptr)
+    munmap(ptr,sz);
+  if(file!=-1)
+    close(int(file));
+  ptr     = nullptr;
+  sz      = 0;
+  file    = -1;
+  mapping = -1;
+  }
+#endif
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+// Memory mapped file.
+// Content is paged in on access and can be evicted by OS at any time,
+// so it does not count to resident memory of the process.
+class MappedFile final {
+  public:
+    MappedFile() = default;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator = (MappedFile&& other) noexcept;
+    ~MappedFile();
+
+    // copies 'data' into a new temporary file; returns empty object on failure
+    static MappedFile spill(const void* data, size_t size);
+    // maps existing file copy-on-write: writes are private to process; returns empty object on failure
+    static MappedFile open(const std::string& path);
+
+    bool           isEmpty() const { return ptr==nullptr; }
+    uint8_t*       data()          { return ptr; }
+    const uint8_t* data()    const { return ptr; }
+    size_t         size()    const { return sz;  }
+
+  private:
+    void           release();
+
+    uint8_t*       ptr     = nullptr;
+    size_t         sz      = 0;
+    // platform handles: file descriptor or HANDLE of file and mapping
+    intptr_t       file    = -1;
+    intptr_t       mapping = -1;
+  };
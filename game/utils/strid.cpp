@@ -0,0 +1,140 @@
+#include "strid.h"
+
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace {
+// Append-only table: readers never lock.
+// Strings are published through fixed chunks of views; lookup is open-addressing hash,
+// that only gets new slots filled in-place. On growth index is rebuilt and swapped,
+// old one is retired (but kept alive) - concurrent readers may still use it.
+struct StrTable {
+  static constexpr uint32_t ChunkBits = 12;
+  static constexpr uint32_t ChunkSize = 1u<<ChunkBits;
+  static constexpr uint32_t MaxChunks = 4096;
+
+  struct Chunk {
+    std::string_view str[ChunkSize] = {};
+    };
+
+  struct Index {
+    explicit Index(size_t size):mask(size-1), slot(new std::atomic<uint64_t>[size]) {
+      for(size_t i=0; i<size; ++i)
+        slot[i].store(0,std::memory_order_relaxed);
+      }
+    const size_t                             mask;
+    std::unique_ptr<std::atomic<uint64_t>[]> slot; // hash<<32 | id, zero - empty
+    };
+
+  StrTable() {
+    chunks.emplace_back(new Chunk());
+    chunk[0].store(chunks.back().get(),std::memory_order_relaxed);
+    indices.emplace_back(new Index(1024));
+    index.store(indices.back().get(),std::memory_order_release);
+    count = 1;
+    }
+
+  static uint32_t hash(std::string_view s) {
+    return uint32_t(std::hash<std::string_view>()(s));
+    }
+
+  std::string_view at(uint32_t id) const {
+    return chunk[id>>ChunkBits].load(std::memory_order_acquire)->str[id&(ChunkSize-1)];
+    }
+
+  uint32_t find(std::string_view s, uint32_t h) const {
+    auto& ix = *index.load(std::memory_order_acquire);
+    for(size_t i=h&ix.mask; ; i=(i+1)&ix.mask) {
+      const uint64_t v = ix.slot[i].load(std::memory_order_acquire);
+      if(v==0)
+        return 0;
+      if(uint32_t(v>>32)==h && at(uint32_t(v))==s)
+        return uint32_t(v);
+      }
+    }
+
+  uint32_t insert(std::string_view s, uint32_t h) {
+    std::lock_guard<std::mutex> guard(sync);
+    if(auto id = find(s,h))
+      return id;
+
+    const uint32_t id = count;
+    if((id&(ChunkSize-1))==0) {
+      if((id>>ChunkBits)>=MaxChunks)
+        throw std::bad_alloc();
+      chunks.emplace_back(new Chunk());
+      chunk[id>>ChunkBits].store(chunks.back().get(),std::memory_order_release);
+      }
+    str.emplace_back(s);
+    chunks[id>>ChunkBits]->str[id&(ChunkSize-1)] = str.back();
+    count++;
+
+    auto* ix = index.load(std::memory_order_relaxed);
+    if(size_t(count)*2>ix->mask+1)
+      ix = grow(*ix);
+    place(*ix,h,id);
+    return id;
+    }
+
+  Index* grow(const Index& prev) {
+    indices.emplace_back(new Index((prev.mask+1)*2));
+    auto* ix = indices.back().get();
+    for(size_t i=0; i<=prev.mask; ++i) {
+      const uint64_t v = prev.slot[i].load(std::memory_order_relaxed);
+      if(v!=0)
+        place(*ix,uint32_t(v>>32),uint32_t(v));
+      }
+    index.store(ix,std::memory_order_release);
+    return ix;
+    }
+
+  static void place(Index& ix, uint32_t h, uint32_t id) {
+    size_t i = h&ix.mask;
+    while(ix.slot[i].load(std::memory_order_relaxed)!=0)
+      i = (i+1)&ix.mask;
+    ix.slot[i].store((uint64_t(h)<<32) | id,std::memory_order_release);
+    }
+
+  std::atomic<Chunk*>                 chunk[MaxChunks] = {};
+  std::atomic<Index*>                 index{nullptr};
+
+  // writer state, guarded by sync
+  std::mutex                          sync;
+  uint32_t                            count = 0;
+  std::deque<std::string>             str; // deque: stable storage for views in chunks
+  std::vector<std::unique_ptr<Chunk>> chunks;
+  std::vector<std::unique_ptr<Index>> indices;
+  };
+
+StrTable& table() {
+  static StrTable t;
+  return t;
+  }
+}
+
+StrId::StrId(std::string_view s) {
+  if(s.empty())
+    return;
+  auto&      t = table();
+  const auto h = StrTable::hash(s);
+  val = t.find(s,h);
+  if(val==0)
+    val = t.insert(s,h);
+  }
+
+StrId StrId::find(std::string_view s) {
+  StrId ret;
+  if(s.empty())
+    return ret;
+  ret.val = table().find(s,StrTable::hash(s));
+  return ret;
+  }
+
+std::string_view StrId::str() const {
+  return table().at(val);
+  }
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <string_view>
+#include <cstdint>
+#include <functional>
+
+// Interned string: equal strings share one 32-bit id for the lifetime of the process.
+// Intended for names, that are compared or looked up every frame (waypoints, triggers, animations).
+class StrId final {
+  public:
+    StrId() = default;
+    explicit StrId(std::string_view s);
+
+    // lookup only: returns empty id, if string was never interned
+    static StrId     find(std::string_view s);
+
+    bool             isEmpty() const { return val==0; }
+    uint32_t         id()      const { return val;    }
+    std::string_view str()     const;
+
+    bool operator == (StrId other) const { return val==other.val; }
+    bool operator != (StrId other) const { return val!=other.val; }
+    bool operator <  (StrId other) const { return val< other.val; }
+
+  private:
+    uint32_t         val = 0;
+  };
+
+namespace std {
+template<>
+struct hash<StrId> {
+  size_t operator()(StrId s) const noexcept { return std::hash<uint32_t>()(s.id()); }
+  };
+}
@@ -1,23 +1,101 @@
 #include "workers.h"
 
-#include <Tempest/Log>
+static thread_local size_t workerId = size_t(-1);
 
-using namespace Tempest;
+void Workers::Queue::push(const Job& j) {
+  std::lock_guard<std::mutex> guard(sync);
+  jobs.push_back(j);
+  size.store(jobs.size());
+  }
+
+bool Workers::Queue::popBack(Job& j) {
+  if(size.load()==0)
+    return false;
+  std::lock_guard<std::mutex> guard(sync);
+  if(jobs.empty())
+    return false;
+  j = jobs.back();
+  jobs.pop_back();
+  size.store(jobs.size());
+  return true;
+  }
+
+bool Workers::Queue::popFront(Job& j) {
+  if(size.load()==0)
+    return false;
+  std::lock_guard<std::mutex> guard(sync);
+  if(jobs.empty())
+    return false;
+  j = jobs.front();
+  jobs.pop_front();
+  size.store(jobs.size());
+  return true;
+  }
+
+Workers::TaskGraph::~TaskGraph() {
+  Workers::wait(group);
+  }
+
+Workers::TaskGraph::Id Workers::TaskGraph::add(std::function<void()> fn) {
+  nodes.emplace_back();
+  nodes.back().fn = std::move(fn);
+  return nodes.size()-1;
+  }
+
+void Workers::TaskGraph::depend(Id task, Id on) {
+  nodes[on].next.push_back(task);
+  nodes[task].deps++;
+  }
+
+void Workers::TaskGraph::clear() {
+  Workers::wait(group);
+  nodes.clear();
+  }
+
+void Workers::TaskGraph::start() {
+  Workers::wait(group);
+  for(auto& i:nodes)
+    i.remain.store(i.deps);
+  auto& w = inst();
+  for(size_t i=0; i<nodes.size(); ++i)
+    if(nodes[i].deps==0)
+      w.push(Job{&exec,this,i,0,&group});
+  }
+
+void Workers::TaskGraph::wait() {
+  Workers::wait(group);
+  }
+
+void Workers::TaskGraph::exec(void* ctx, size_t id, size_t) {
+  auto& g = *reinterpret_cast<TaskGraph*>(ctx);
+  auto& n = g.nodes[id];
+  if(n.fn)
+    n.fn();
+  auto& w = inst();
+  for(auto next:n.next)
+    if(g.nodes[next].remain.fetch_sub(1)==1)
+      w.push(Job{&exec,ctx,next,0,&g.group});
+  }
 
 Workers::Workers() {
-  size_t id=0;
-  for(auto& i:th) {
-    i = std::thread([this,id]() noexcept {
+  size_t cnt = std::max<size_t>(std::thread::hardware_concurrency(),2)-1;
+  // one queue per worker + one shared by all external threads
+  for(size_t i=0; i<=cnt; ++i)
+    queues.emplace_back(new Queue());
+  th.resize(cnt);
+  for(size_t id=0; id<cnt; ++id) {
+    th[id] = std::thread([this,id]() noexcept {
       threadFunc(id);
       });
-    ++id;
     }
   }
 
 Workers::~Workers() {
-  running   = false;
-  workTasks = MAX_THREADS;
-  execWork();
+  {
+    std::unique_lock<std::mutex> lck(sync);
+    running = false;
+  }
+  wakeWait.notify_all();
   for(auto& i:th)
     i.join();
   }
@@ -27,46 +105,94 @@ Workers &Workers::inst() {
   return w;
   }
 
+size_t Workers::threadCount() {
+  return inst().th.size()+1;
+  }
+
+void Workers::wait(Group& g) {
+  auto& w = inst();
+  while(!g.isDone()) {
+    Job j;
+    if(w.pop(j)) {
+      w.exec(j);
+      continue;
+      }
+    std::unique_lock<std::mutex> lck(w.sync);
+    w.sleeping.fetch_add(1);
+    while(!g.isDone() && w.queued.load()==0)
+      w.wakeWait.wait(lck);
+    w.sleeping.fetch_sub(1);
+    }
+  }
+
+void Workers::execFunction(void* ctx, size_t, size_t) {
+  std::unique_ptr<std::function<void()>> fn(reinterpret_cast<std::function<void()>*>(ctx));
+  (*fn)();
+  }
+
 void Workers::threadFunc(size_t id) {
+  workerId = id;
   while(true) {
-    {
-    std::unique_lock<std::mutex> lck(sync);
-    while(!workInc[id])
-      workWait.wait(lck);
-    workInc[id]=false;
-    }
+    Job j;
+    if(pop(j)) {
+      exec(j);
+      continue;
+      }
 
-    if(!running) {
-      workDone.fetch_add(1);
+    std::unique_lock<std::mutex> lck(sync);
+    if(!running)
       return;
-      }
+    sleeping.fetch_add(1);
+    while(queued.load()==0 && running)
+      wakeWait.wait(lck);
+    sleeping.fetch_sub(1);
+    }
+  }
 
-    size_t b = std::min((id  )*batchSize, workSize);
-    size_t e = std::min((id+1)*batchSize, workSize);
-    // Log::d("worker: id = ",id," [",b, ", ",e,"]");
+void Workers::push(const Job& j) {
+  j.group->pending.fetch_add(1);
+  queued.fetch_add(1);
+  localQueue().push(j);
+  if(sleeping.load()>0) {
+    std::lock_guard<std::mutex> guard(sync);
+    wakeWait.notify_one();
+    }
+  }
 
-    if(b!=e) {
-      void* d = &workSet[b*workEltSize];
-      workFunc(d,e-b);
+bool Workers::pop(Job& j) {
+  if(queued.load()==0)
+    return false;
+  size_t id = workerId<th.size() ? workerId : th.size();
+  if(queues[id]->popBack(j)) {
+    queued.fetch_sub(1);
+    return true;
+    }
+  // steal oldest (largest) jobs from other threads
+  for(size_t i=1; i<queues.size(); ++i) {
+    auto& q = *queues[(id+i)%queues.size()];
+    if(q.popFront(j)) {
+      queued.fetch_sub(1);
+      return true;
       }
+    }
+  return false;
+  }
 
-    workDone.fetch_add(1);
+void Workers::exec(Job& j) {
+  Group& g = *j.group;
+  j.fn(j.ctx,j.b,j.e);
+  if(g.pending.fetch_sub(1)==1) {
+    // group may be released by waiter at this point
+    std::lock_guard<std::mutex> guard(sync);
+    wakeWait.notify_all();
     }
   }
 
-void Workers::execWork() {
-  {
-    std::unique_lock<std::mutex> lck(sync);
-    for(size_t i=0; i<workTasks; ++i)
-      workInc[i]=true;
-    workWait.notify_all();
+bool Workers::needSplit() {
+  return localQueue().size.load()<2 || sleeping.load()>0;
   }
-  std::this_thread::yield();
 
-  while(true) {
-    int expect = int(workTasks);
-    if(workDone.compare_exchange_strong(expect,0,std::memory_order::memory_order_acq_rel))
-      break;
-    std::this_thread::yield();
-    }
+Workers::Queue& Workers::localQueue() {
+  size_t id = workerId<th.size() ? workerId : th.size();
+  return *queues[id];
   }
@@ -2,71 +2,190 @@
 
 #include <thread>
 #include <mutex>
+#include <condition_variable>
+#include <deque>
 #include <vector>
 #include <functional>
 #include <atomic>
 #include <algorithm>
-
-#include "semaphore.h"
+#include <memory>
 
 class Workers final {
   public:
     Workers();
     ~Workers();
 
+    class Group final {
+      public:
+        Group() = default;
+        Group(const Group&) = delete;
+        ~Group() { Workers::wait(*this); }
+
+        bool isDone() const { return pending.load(std::memory_order_acquire)==0; }
+
+      private:
+        std::atomic<size_t> pending{0};
+      friend class Workers;
+      };
+
+    class TaskGraph final {
+      public:
+        using Id = size_t;
+
+        TaskGraph() = default;
+        TaskGraph(const TaskGraph&) = delete;
+        ~TaskGraph();
+
+        Id   add(std::function<void()> fn);
+        void depend(Id task, Id on);
+        void clear();
+
+        void start();
+        void wait();
+        void run() { start(); wait(); }
+        bool isDone() const { return group.isDone(); }
+
+      private:
+        struct Node {
+          std::function<void()> fn;
+          std::vector<Id>       next;
+          uint32_t              deps=0;
+          std::atomic<uint32_t> remain{0};
+          };
+
+        static void exec(void* ctx, size_t id, size_t);
+
+        std::deque<Node> nodes;
+        Group            group;
+      };
+
+    static size_t threadCount();
+
     template<class T,class F>
     static void parallelFor(T* b, T* e, const F& func) {
-      inst().runParallelFor(b,std::distance(b,e),std::thread::hardware_concurrency(),func);
+      parallelFor(b,size_t(std::distance(b,e)),threadCount(),func);
       }
 
     template<class T,class F>
     static void parallelFor(std::vector<T>& data, const F& func) {
-      inst().runParallelFor(data.data(),data.size(),std::thread::hardware_concurrency(),func);
+      parallelFor(data.data(),data.size(),threadCount(),func);
       }
 
     template<class T,class F>
     static void parallelFor(std::vector<T>& data, size_t maxTh, const F& func) {
-      inst().runParallelFor(data.data(),data.size(),maxTh,func);
+      parallelFor(data.data(),data.size(),maxTh,func);
       }
 
+    // func(begin,end) is called for disjoint sub-ranges of [0,sz); ranges are split on demand
+    template<class F>
+    static void parallelRange(size_t sz, size_t minGrain, const F& func) {
+      if(sz==0)
+        return;
+      Group         g;
+      RangeCtx<F>   ctx{&func,std::max<size_t>(minGrain,1),&g};
+      execRange<F>(&ctx,0,sz);
+      wait(g);
+      }
+
+    template<class F>
+    static void spawn(Group& g, F&& fn) {
+      auto* f = new std::function<void()>(std::forward<F>(fn));
+      inst().push(Job{&execFunction,f,0,0,&g});
+      }
+
+    static void wait(Group& g);
+
   private:
-    enum { MAX_THREADS=16 };
+    struct Job {
+      void   (*fn)(void* ctx, size_t b, size_t e) = nullptr;
+      void*    ctx   = nullptr;
+      size_t   b     = 0;
+      size_t   e     = 0;
+      Group*   group = nullptr;
+      };
+
+    struct Queue {
+      std::mutex          sync;
+      std::deque<Job>     jobs;
+      std::atomic<size_t> size{0};
+
+      void push(const Job& j);
+      bool popBack (Job& j);
+      bool popFront(Job& j);
+      };
+
+    template<class F>
+    struct RangeCtx {
+      const F* func;
+      size_t   grain;
+      Group*   group;
+      };
 
-    void threadFunc(size_t id);
-    void execWork();
     static Workers& inst();
 
     template<class T,class F>
-    void runParallelFor(T* data, size_t sz, size_t maxTh, const F& func) {
-      workSet     = reinterpret_cast<uint8_t*>(data);
-      workSize    = sz;
-      workEltSize = sizeof(T);
-
-      workFunc = [&func](void* data,size_t sz) {
-        T* tdata = reinterpret_cast<T*>(data);
-        for(size_t i=0;i<sz;++i)
-          func(tdata[i]);
-        };
-
-      if(maxTh>MAX_THREADS)
-        workTasks = MAX_THREADS; else
-        workTasks = maxTh;
-
-      batchSize = std::max<size_t>(16,(sz+workTasks-1)/workTasks);
-      execWork();
+    struct ForCtx {
+      T*                  data;
+      size_t              sz;
+      size_t              chunk;
+      const F*            func;
+      std::atomic<size_t> next{0};
+      };
+
+    // at most maxTh workers (caller included) pull chunks of items from shared counter
+    template<class T,class F>
+    static void parallelFor(T* data, size_t sz, size_t maxTh, const F& func) {
+      const size_t thCount = std::min(std::max<size_t>(maxTh,1),sz);
+      if(thCount<=1) {
+        for(size_t i=0; i<sz; ++i)
+          func(data[i]);
+        return;
+        }
+      Group         g;
+      ForCtx<T,F>   ctx{data,sz,std::max<size_t>(1,sz/(thCount*8)),&func};
+      for(size_t i=1; i<thCount; ++i)
+        inst().push(Job{&execFor<T,F>,&ctx,0,0,&g});
+      execFor<T,F>(&ctx,0,0);
+      wait(g);
+      }
+
+    template<class T,class F>
+    static void execFor(void* c, size_t, size_t) {
+      auto& ctx = *reinterpret_cast<ForCtx<T,F>*>(c);
+      for(size_t b=ctx.next.fetch_add(ctx.chunk); b<ctx.sz; b=ctx.next.fetch_add(ctx.chunk)) {
+        const size_t e = std::min(b+ctx.chunk,ctx.sz);
+        for(size_t i=b; i<e; ++i)
+          (*ctx.func)(ctx.data[i]);
+        }
+      }
+
+    template<class F>
+    static void execRange(void* c, size_t b, size_t e) {
+      auto& ctx = *reinterpret_cast<RangeCtx<F>*>(c);
+      auto& w   = inst();
+      while(e-b>ctx.grain && w.needSplit()) {
+        size_t m = b+(e-b)/2;
+        w.push(Job{&execRange<F>,c,m,e,ctx.group});
+        e = m;
+        }
+      (*ctx.func)(b,e);
       }
 
-    std::thread                       th     [MAX_THREADS];
-    bool                              workInc[MAX_THREADS];
+    static void execFunction(void* ctx, size_t, size_t);
 
-    bool                              running=true;
+    void   threadFunc(size_t id);
+    void   push(const Job& j);
+    bool   pop (Job& j);
+    void   exec(Job& j);
+    bool   needSplit();
+    Queue& localQueue();
 
-    uint8_t*                          workSet=nullptr;
-    size_t                            workSize=0, batchSize=0, workEltSize=0;
-    size_t                            workTasks=0;
-    std::function<void(void*,size_t)> workFunc;
+    std::vector<std::thread>            th;
+    std::vector<std::unique_ptr<Queue>> queues;
+    bool                                running=true;
 
-    std::mutex                        sync;
-    std::condition_variable           workWait;
-    std::atomic_int                   workDone{0};
+    std::atomic<size_t>                 queued{0};
+    std::atomic<size_t>                 sleeping{0};
+    std::mutex                          sync;
+    std::condition_variable             wakeWait;
   };
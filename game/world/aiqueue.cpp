@@ -27,6 +27,8 @@ void AiQueue::load(Serialize& fin) {
     if(fin.version()>=4)
       fin.read(i.i1);
     fin.read(i.s0);
+    if(i.act==AI_GoToNextFp)
+      i.fp = StrId(i.s0.c_str());
     }
   }
 
@@ -105,6 +107,7 @@ AiQueue::AiAction AiQueue::aiGoToNextFp(const Daedalus::ZString& fp) {
   AiAction a;
   a.act = AI_GoToNextFp;
   a.s0  = fp;
+  a.fp  = StrId(fp.c_str());
   return a;
   }
 
@@ -6,6 +6,7 @@
 
 #include "game/gamescript.h"
 #include "game/constants.h"
+#include "utils/strid.h"
 
 class Npc;
 class Item;
@@ -26,6 +27,7 @@ class AiQueue {
       int               i0    =0;
       int               i1    =0;
       Daedalus::ZString s0;
+      StrId             fp; // free-point name of AI_GoToNextFp, resolved once
       };
 
     void     save(Serialize& fout) const;
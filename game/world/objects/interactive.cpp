@@ -167,8 +167,8 @@ void Interactive::setVisual(ZenLoad::zCVobData& vob) {
   setAnim(Interactive::Active); // setup default anim
   }
 
-void Interactive::updateAnimation() {
-  if(visual.updateAnimation(nullptr,world))
+void Interactive::updateAnimation(Pose::Lod lod) {
+  if(visual.updateAnimation(nullptr,world,lod))
     animChanged = true;
   }
 
@@ -31,7 +31,8 @@ class Interactive : public Vob {
     void                postValidate();
 
     void                resetPositionToTA();
-    void                updateAnimation();
+    void                updateAnimation(Pose::Lod lod = Pose::LodFull);
+    bool                isVisible() const { return visual.isVisible(); }
     void                tick(uint64_t dt);
 
     std::string_view    tag() const;
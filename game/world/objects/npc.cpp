@@ -4,6 +4,7 @@
 #include <Tempest/Log>
 
 #include <zenload/zCMaterial.h>
+#include <atomic>
 
 #include "graphics/mesh/skeleton.h"
 #include "graphics/mesh/animmath.h"
@@ -21,6 +22,9 @@
 
 using namespace Tempest;
 
+// per-npc serial, to spread time-sliced npc evenly over frames
+static std::atomic<uint32_t> lodSerialCounter{0};
+
 void Npc::GoTo::save(Serialize& fout) const {
   fout.write(npc, uint8_t(flag), wp, pos);
   }
@@ -160,6 +164,7 @@ struct Npc::TransformBack {
 Npc::Npc(World &owner, size_t instance, std::string_view waypoint)
   :owner(owner),mvAlgo(*this) {
   outputPipe          = owner.script().openAiOuput();
+  lodSerial           = lodSerialCounter.fetch_add(1,std::memory_order_relaxed);
   hnpc.userPtr        = this;
   hnpc.instanceSymbol = instance;
 
@@ -176,6 +181,7 @@ Npc::Npc(World &owner, size_t instance, std::string_view waypoint)
 Npc::Npc(World &owner, Serialize &fin)
   :owner(owner),mvAlgo(*this) {
   outputPipe   = owner.script().openAiOuput();
+  lodSerial    = lodSerialCounter.fetch_add(1,std::memory_order_relaxed);
   hnpc.userPtr = this;
 
   load(fin);
@@ -503,6 +509,24 @@ void Npc::setProcessPolicy(ProcessPolicy t) {
   aiPolicy=t;
   }
 
+void Npc::skipTick(uint64_t dt) {
+  // time-sliced by ai-lod: pending time and slices are consumed by next tick
+  skippedDt += dt;
+  skippedTicks++;
+  }
+
+bool Npc::prefetchRays(DynamicWorld::RayBatch& rb, uint64_t dt) {
+  return mvAlgo.prefetchRays(rb,dt+skippedDt);
+  }
+
+void Npc::applyRays(const DynamicWorld::RayBatch& rb, size_t id) {
+  mvAlgo.applyRays(rb,id);
+  }
+
+MoveAlgo::RayPrefetch Npc::takeRayPrefetch() {
+  return mvAlgo.takeRayPrefetch();
+  }
+
 void Npc::setWalkMode(WalkBit m) {
   wlkMode = m;
   }
@@ -695,8 +719,8 @@ uint8_t Npc::calcAniComb() const {
   return Pose::calcAniComb(dpos,angle);
   }
 
-void Npc::updateAnimation() {
-  bool syncAtt = visual.updateAnimation(this,owner);
+void Npc::updateAnimation(Pose::Lod lod) {
+  bool syncAtt = visual.updateAnimation(this,owner,lod);
   if(durtyTranform) {
     updatePos();
     syncAtt = true;
@@ -803,8 +827,8 @@ void Npc::dropTorch(bool burnout) {
     }
   }
 
-Tempest::Vec3 Npc::animMoveSpeed(uint64_t dt) const {
-  return visual.pose().animMoveSpeed(owner.tickCount(),dt);
+Tempest::Vec3 Npc::animMoveSpeed(uint64_t dt, uint64_t offset) const {
+  return visual.pose().animMoveSpeed(owner.tickCount()+offset,dt);
   }
 
 void Npc::setVisual(const Skeleton* v) {
@@ -1061,7 +1085,8 @@ bool Npc::hasAnim(std::string_view scheme) const {
   }
 
 bool Npc::isFinishingMove() const {
-  return visual.pose().isInAnim("T_1HSFINISH") || visual.pose().isInAnim("T_2HSFINISH");
+  static const StrId t1h("T_1HSFINISH"), t2h("T_2HSFINISH");
+  return visual.pose().isInAnim(t1h) || visual.pose().isInAnim(t2h);
   }
 
 bool Npc::isStanding() const {
@@ -1592,10 +1617,11 @@ bool Npc::implAtack(uint64_t dt) {
 
 void Npc::adjustAtackRotation(uint64_t dt) {
   if(currentTarget!=nullptr && !currentTarget->isDown()) {
+    static const StrId fist("T_FISTATTACKMOVE"), w1h("T_1HATTACKMOVE"), w2h("T_2HATTACKMOVE");
     auto ws = weaponState();
-    if(!visual.pose().isInAnim("T_FISTATTACKMOVE") &&
-       !visual.pose().isInAnim("T_1HATTACKMOVE")   &&
-       !visual.pose().isInAnim("T_2HATTACKMOVE")   &&
+    if(!visual.pose().isInAnim(fist) &&
+       !visual.pose().isInAnim(w1h)  &&
+       !visual.pose().isInAnim(w2h)  &&
        ws!=WeaponState::NoWeapon){
       bool noAnim = !hasAutoroll();
       if(ws==WeaponState::Bow || ws==WeaponState::CBow || ws==WeaponState::Mage)
@@ -1617,6 +1643,13 @@ bool Npc::implAiTick(uint64_t dt) {
   return true;
   }
 
+bool Npc::isAiWaiting() const {
+  return waitTime>=owner.tickCount()    ||
+         aniWaitTime>=owner.tickCount() ||
+         outWaitTime>owner.tickCount()  ||
+         !go2.empty();
+  }
+
 void Npc::implAiWait(uint64_t dt) {
   auto w = owner.tickCount()+dt;
   if(w>waitTime)
@@ -1857,6 +1890,12 @@ Npc* Npc::updateNearestBody() {
   }
 
 void Npc::tick(uint64_t dt) {
+  // ai queues advance once per skipped slice too, as if npc was ticked every frame
+  const uint32_t slices = skippedTicks+1;
+  dt          += skippedDt;
+  skippedDt    = 0;
+  skippedTicks = 0;
+
   Animation::EvCount ev;
   visual.pose().processEvents(lastEventTime,owner.tickCount(),ev);
   visual.processLayers(owner);
@@ -1892,7 +1931,11 @@ void Npc::tick(uint64_t dt) {
       }
     }
 
-  nextAiAction(aiQueueOverlay,dt);
+  for(uint32_t i=0; i<slices && aiQueueOverlay.size()>0; ++i) {
+    if(i>0 && isAiWaiting())
+      break;
+    nextAiAction(aiQueueOverlay,dt/slices);
+    }
 
   if(tickCast())
     return;
@@ -1922,7 +1965,12 @@ void Npc::tick(uint64_t dt) {
     }
 
   mvAlgo.tick(dt);
-  implAiTick(dt);
+  for(uint32_t i=0; i<slices; ++i) {
+    if(i>0 && isAiWaiting())
+      break;
+    if(!implAiTick(dt/slices))
+      break;
+    }
   }
 
 void Npc::nextAiAction(AiQueue& queue, uint64_t dt) {
@@ -1958,7 +2006,7 @@ void Npc::nextAiAction(AiQueue& queue, uint64_t dt) {
         queue.pushFront(std::move(act));
         break;
         }
-      auto fp = owner.findNextFreePoint(*this,act.s0.c_str());
+      auto fp = owner.findNextFreePoint(*this,act.fp);
       if(fp!=nullptr) {
         currentFp       = nullptr;
         currentFpLock   = FpLock(*fp);
@@ -1973,8 +2021,18 @@ void Npc::nextAiAction(AiQueue& queue, uint64_t dt) {
         break;
         }
       if(wayPath.last()!=act.point) {
-        wayPath     = owner.wayTo(*this,*act.point);
-        auto wpoint = wayPath.pop();
+        // path is searched on worker thread; action is retried, until path is ready
+        if(!wayPathReq.isValid() || wayPathReqTo!=act.point) {
+          wayPathReq   = owner.wayToAsync(*this,*act.point);
+          wayPathReqTo = act.point;
+          }
+        if(!wayPathReq.isReady()) {
+          queue.pushFront(std::move(act));
+          break;
+          }
+        wayPath      = wayPathReq.take();
+        wayPathReqTo = nullptr;
+        auto wpoint  = wayPath.pop();
 
         if(wpoint!=nullptr) {
           go2.set(wpoint);
@@ -3342,6 +3400,25 @@ void Npc::startDialog(Npc& pl) {
     setOther(&pl);
   }
 
+void Npc::perceptionScan(Npc& pl) {
+  // thread-safe: only ray-casts and own state are touched here
+  percScan = PercScan();
+  if(isPlayer() || processPolicy()!=Npc::AiNormal)
+    return;
+  percScan.player = hasPerc(PERC_ASSESSPLAYER) && canSenseNpc(pl,false)!=SensesBit::SENSE_NONE;
+  percScan.enemy  = hasPerc(PERC_ASSESSENEMY)  ? updateNearestEnemy() : nullptr;
+  percScan.body   = hasPerc(PERC_ASSESSBODY)   ? updateNearestBody()  : nullptr;
+  }
+
+bool Npc::needMoveMob() const {
+  return hasPerc(PERC_MOVEMOB) && interactive()==nullptr && moveMobCacheKey!=position();
+  }
+
+void Npc::setMoveMob(Interactive* mob) {
+  moveMob         = mob;
+  moveMobCacheKey = position();
+  }
+
 bool Npc::perceptionProcess(Npc &pl) {
   static bool disable=false;
   if(disable)
@@ -3352,10 +3429,9 @@ bool Npc::perceptionProcess(Npc &pl) {
 
   bool ret=false;
   if(hasPerc(PERC_MOVEMOB) && interactive()==nullptr) {
-    if(moveMobCacheKey!=position()) {
-      moveMob         = owner.findInteractive(*this);
-      moveMobCacheKey = position();
-      }
+    // usually resolved in batch by WorldObjects::tickPerception
+    if(moveMobCacheKey!=position())
+      setMoveMob(owner.findInteractive(*this));
     if(moveMob!=nullptr && perceptionProcess(*this,nullptr,0,PERC_MOVEMOB)) {
       ret = true;
       }
@@ -3366,12 +3442,12 @@ bool Npc::perceptionProcess(Npc &pl) {
 
   const float quadDist = pl.qDistTo(*this);
 
-  if(hasPerc(PERC_ASSESSPLAYER) && canSenseNpc(pl,false)!=SensesBit::SENSE_NONE) {
+  if(percScan.player) {
     if(perceptionProcess(pl,nullptr,quadDist,PERC_ASSESSPLAYER)) {
       ret = true;
       }
     }
-  Npc* enem=hasPerc(PERC_ASSESSENEMY) ? updateNearestEnemy() : nullptr;
+  Npc* enem=percScan.enemy;
   if(enem!=nullptr){
     float dist=qDistTo(*enem);
     if(perceptionProcess(*enem,nullptr,dist,PERC_ASSESSENEMY)){
@@ -3381,7 +3457,7 @@ bool Npc::perceptionProcess(Npc &pl) {
       }
     }
 
-  Npc* body=hasPerc(PERC_ASSESSBODY) ? updateNearestBody() : nullptr;
+  Npc* body=percScan.body;
   if(body!=nullptr){
     float dist=qDistTo(*body);
     if(perceptionProcess(*body,nullptr,dist,PERC_ASSESSBODY)) {
@@ -3389,7 +3465,8 @@ bool Npc::perceptionProcess(Npc &pl) {
       }
     }
 
-  perceptionNextTime=owner.tickCount()+perceptionTime;
+  percScan           = PercScan();
+  perceptionNextTime = owner.tickCount()+perceptionTime;
   return ret;
   }
 
@@ -3666,6 +3743,8 @@ void Npc::attachToPoint(const WayPoint *p) {
 
 void Npc::clearGoTo() {
   wayPath.clear();
+  wayPathReq   = WayMatrix::PathRequest();
+  wayPathReqTo = nullptr;
   if(!go2.empty()) {
     stopWalking();
     go2.clear();
@@ -14,6 +14,7 @@
 #include "world/aiqueue.h"
 #include "world/fplock.h"
 #include "world/waypath.h"
+#include "world/waymatrix.h"
 
 #include <cstdint>
 #include <string>
@@ -104,7 +105,12 @@ class Npc final {
     bool       resetPositionToTA();
 
     void       setProcessPolicy(ProcessPolicy t);
+    void       skipTick(uint64_t dt);
+    bool       prefetchRays(DynamicWorld::RayBatch& rb, uint64_t dt);
+    void       applyRays   (const DynamicWorld::RayBatch& rb, size_t id);
+    auto       takeRayPrefetch() -> MoveAlgo::RayPrefetch;
     auto       processPolicy() const -> ProcessPolicy { return aiPolicy; }
+    uint32_t   lodPhase() const { return lodSerial; }
 
     bool       isPlayer() const;
     void       setWalkMode(WalkBit m);
@@ -125,7 +131,8 @@ class Npc final {
     float      qDistTo(const Npc& p) const;
     float      qDistTo(const Interactive& p) const;
 
-    void       updateAnimation();
+    void       updateAnimation(Pose::Lod lod = Pose::LodFull);
+    bool       isVisible() const { return visual.isVisible(); }
     void       updateTransform();
 
     std::string_view displayName() const;
@@ -168,7 +175,7 @@ class Npc final {
     bool       hasAnim(std::string_view scheme) const;
     bool       isFinishingMove() const;
 
-    auto       animMoveSpeed(uint64_t dt) const -> Tempest::Vec3;
+    auto       animMoveSpeed(uint64_t dt, uint64_t offset=0) const -> Tempest::Vec3;
 
     bool       isJumpAnim() const;
     bool       isFlyAnim() const;
@@ -268,6 +275,9 @@ class Npc final {
     void      setPerceptionEnable (PercType t, size_t fn);
     void      setPerceptionDisable(PercType t);
 
+    void      perceptionScan   (Npc& pl);
+    bool      needMoveMob() const;
+    void      setMoveMob(Interactive* mob);
     bool      perceptionProcess(Npc& pl);
     bool      perceptionProcess(Npc& pl, Npc *victum, float quadDist, PercType perc);
     bool      hasPerc(PercType perc) const;
@@ -404,6 +414,13 @@ class Npc final {
       ScriptFn func;
       };
 
+    // result of perceptionScan: what npc can sense, before any script is called
+    struct PercScan final {
+      bool     player = false;
+      Npc*     enemy  = nullptr;
+      Npc*     body   = nullptr;
+      };
+
     struct GoTo final {
       GoToHint         flag = GoToHint::GT_No;
       Npc*             npc  = nullptr;
@@ -447,6 +464,7 @@ class Npc final {
     bool      implAtack  (uint64_t dt);
     void      adjustAtackRotation(uint64_t dt);
     bool      implAiTick (uint64_t dt);
+    bool      isAiWaiting() const;
     void      implAiWait (uint64_t dt);
     void      implAniWait(uint64_t dt);
     void      implFaiWait(uint64_t dt);
@@ -512,6 +530,7 @@ class Npc final {
     uint64_t                       perceptionTime    =0;
     uint64_t                       perceptionNextTime=0;
     Perc                           perception[PERC_Count];
+    PercScan                       percScan;
 
     // inventory
     Inventory                      invent;
@@ -539,6 +558,9 @@ class Npc final {
 
     uint64_t                       aiOutputBarrier=0;
     ProcessPolicy                  aiPolicy=ProcessPolicy::AiNormal;
+    uint64_t                       skippedDt=0;
+    uint32_t                       skippedTicks=0;
+    uint32_t                       lodSerial=0;
     AiState                        aiState;
     ScriptFn                       aiPrevState;
     AiQueue                        aiQueue;
@@ -561,6 +583,8 @@ class Npc final {
     const WayPoint*                currentFp      =nullptr;
     FpLock                         currentFpLock;
     WayPath                        wayPath;
+    WayMatrix::PathRequest         wayPathReq;
+    const WayPoint*                wayPathReqTo   =nullptr;
 
     MoveAlgo                       mvAlgo;
     FightAlgo                      fghAlgo;
@@ -68,6 +68,7 @@ void Vob::setGlobalTransform(const Matrix4x4& p) {
     m.mul(local);
     local = m;
     }
+  world.updateVobIndex(*this);
   }
 
 void Vob::setLocalTransform(const Matrix4x4& p) {
@@ -97,10 +98,8 @@ void Vob::recalculateTransform() {
     } else {
     pos = local;
     }
-  if(old != position() && !isDynamic()) {
-    if(childContent!=cbNone)
-      world.invalidateVobIndex();
-    }
+  if(old != position())
+    world.updateVobIndex(*this);
   moveEvent();
   for(auto& i:child) {
     i->recalculateTransform();
@@ -249,5 +248,6 @@ void Vob::load(Serialize& fin) {
   fin.read(type,pos,local);
   if(vobType!=type && type!=0)
     throw std::logic_error("inconsistent *.sav vs world");
+  world.updateVobIndex(*this);
   moveEvent();
   }
@@ -0,0 +1,133 @@
+#include "soundocclusion.h"
+
+#include <algorithm>
+#include <cmath>
+
+// in centimeters
+static const float    CellSize      = 100.f;
+// cached value is re-evaluated, once it's older than this
+static const uint64_t RefreshFrames = 20;
+// ray-casts per frame for re-evaluation; emitters without any estimate are casted regardless
+static const size_t   RayBudget     = 16;
+// entries, that are not queried for this long, are dropped
+static const uint64_t EvictFrames   = 600;
+
+static size_t hashOf(const int32_t* v, size_t cnt) {
+  uint64_t h = 0xcbf29ce484222325ull;
+  for(size_t i=0; i<cnt; ++i)
+    h = (h^uint32_t(v[i]))*0x100000001b3ull;
+  return size_t(h^(h>>32));
+  }
+
+size_t SoundOcclusion::KeyHash::operator()(const Key& k) const {
+  const int32_t v[6] = {k.listener.x, k.listener.y, k.listener.z, k.emitter.x, k.emitter.y, k.emitter.z};
+  return hashOf(v,6);
+  }
+
+size_t SoundOcclusion::KeyHash::operator()(const Cell& c) const {
+  const int32_t v[3] = {c.x, c.y, c.z};
+  return hashOf(v,3);
+  }
+
+void SoundOcclusion::occlusion(const DynamicWorld& physic, const Tempest::Vec3& listener,
+                               const Tempest::Vec3* emitter, float* occ, size_t count) {
+  frame++;
+  const Cell lc = cellOf(listener);
+
+  pending.clear();
+  stale.clear();
+  for(size_t i=0; i<count; ++i) {
+    const Cell ec = cellOf(emitter[i]);
+    auto it = cache.find(Key{lc,ec});
+    if(it!=cache.end()) {
+      it->second.used = frame;
+      occ[i] = it->second.occ;
+      if(frame-it->second.time>=RefreshFrames)
+        stale.push_back(i);
+      continue;
+      }
+    // listener moved to another cell: last value is good enough, until re-evaluated
+    auto last = latest.find(ec);
+    if(last!=latest.end()) {
+      last->second.used = frame;
+      occ[i] = last->second.occ;
+      stale.push_back(i);
+      continue;
+      }
+    pending.push_back(i);
+    }
+
+  // refreshed entries stay fresh for RefreshFrames, so the rest of 'stale' gets its turn next frames
+  const size_t refresh = std::min(stale.size(), pending.size()<RayBudget ? RayBudget-pending.size() : 0);
+  pending.insert(pending.end(),stale.begin(),stale.begin()+std::ptrdiff_t(refresh));
+
+  if(!pending.empty()) {
+    rays.clear();
+    for(auto i:pending)
+      rays.addSound(listener,emitter[i]);
+    physic.rayBatch(rays);
+
+    for(size_t r=0; r<pending.size(); ++r) {
+      const size_t i = pending[r];
+      occ[i] = rays.occlusion(r);
+      store(Key{lc,cellOf(emitter[i])},occ[i]);
+      }
+    }
+
+  if(frame%EvictFrames==0)
+    evict();
+  }
+
+float SoundOcclusion::occlusion(const DynamicWorld& physic, const Tempest::Vec3& listener, const Tempest::Vec3& emitter) {
+  const Key k{cellOf(listener),cellOf(emitter)};
+  auto it = cache.find(k);
+  if(it!=cache.end()) {
+    it->second.used = frame;
+    return it->second.occ;
+    }
+
+  const float occ = physic.soundOclusion(listener,emitter);
+  store(k,occ);
+  return occ;
+  }
+
+void SoundOcclusion::clear() {
+  cache.clear();
+  latest.clear();
+  }
+
+SoundOcclusion::Cell SoundOcclusion::cellOf(const Tempest::Vec3& v) {
+  auto q = [](float f) {
+    if(!std::isfinite(f))
+      return int32_t(0);
+    f = std::floor(f/CellSize);
+    return int32_t(std::max(-2147483520.f,std::min(f,2147483520.f)));
+    };
+  Cell c;
+  c.x = q(v.x);
+  c.y = q(v.y);
+  c.z = q(v.z);
+  return c;
+  }
+
+void SoundOcclusion::store(const Key& k, float occ) {
+  Entry e;
+  e.occ  = occ;
+  e.time = frame;
+  e.used = frame;
+  cache [k]         = e;
+  latest[k.emitter] = e;
+  }
+
+void SoundOcclusion::evict() {
+  for(auto it=cache.begin(); it!=cache.end();) {
+    if(frame-it->second.used>EvictFrames)
+      it = cache.erase(it); else
+      ++it;
+    }
+  for(auto it=latest.begin(); it!=latest.end();) {
+    if(frame-it->second.used>EvictFrames)
+      it = latest.erase(it); else
+      ++it;
+    }
+  }
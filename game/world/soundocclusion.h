@@ -0,0 +1,60 @@
+#pragma once
+
+#include <Tempest/Point>
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "physics/dynamicworld.h"
+
+// Cache of sound occlusion, keyed by quantized listener and emitter cells.
+// Listener and emitters barely move between frames: cached values are reused,
+// and re-evaluation of outdated ones is spread over frames with a fixed ray budget.
+class SoundOcclusion final {
+  public:
+    SoundOcclusion() = default;
+
+    // called once per frame: occlusion factors of all emitters at once
+    void  occlusion(const DynamicWorld& physic, const Tempest::Vec3& listener,
+                    const Tempest::Vec3* emitter, float* occ, size_t count);
+    // single query for a new sound; does not advance frame
+    float occlusion(const DynamicWorld& physic, const Tempest::Vec3& listener, const Tempest::Vec3& emitter);
+
+    void  clear();
+
+  private:
+    struct Cell {
+      int32_t x=0, y=0, z=0;
+      bool operator == (const Cell& c) const { return x==c.x && y==c.y && z==c.z; }
+      };
+
+    struct Key {
+      Cell listener, emitter;
+      bool operator == (const Key& k) const { return listener==k.listener && emitter==k.emitter; }
+      };
+
+    struct KeyHash {
+      size_t operator()(const Key& k)  const;
+      size_t operator()(const Cell& c) const;
+      };
+
+    struct Entry {
+      float    occ  = 0;
+      uint64_t time = 0; // frame of evaluation
+      uint64_t used = 0; // frame of last query
+      };
+
+    static Cell cellOf(const Tempest::Vec3& v);
+    void        store(const Key& k, float occ);
+    void        evict();
+
+    std::unordered_map<Key,Entry,KeyHash>  cache;
+    // last value per emitter, from any listener cell: estimate, while listener moves
+    std::unordered_map<Cell,Entry,KeyHash> latest;
+    uint64_t                               frame = 0;
+
+    DynamicWorld::RayBatch                 rays;
+    std::vector<size_t>                    pending;
+    std::vector<size_t>                    stale;
+  };
@@ -1,131 +1,316 @@
 #include "spaceindex.h"
 
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP>=2)
+#include <emmintrin.h>
+#define SPACEINDEX_SSE2
+#endif
+
 #include "world/objects/vob.h"
 
-void BaseSpaceIndex::clear() {
-  arr.clear();
-  index.clear();
-  dynamic.clear();
+template<class F>
+static void sphereTest(const float* x, const float* y, const float* z, size_t cnt,
+                       const Tempest::Vec3& p, float R, const F& func) {
+  const float R2 = R*R;
+  size_t      i  = 0;
+#if defined(SPACEINDEX_SSE2)
+  const __m128 px = _mm_set1_ps(p.x);
+  const __m128 py = _mm_set1_ps(p.y);
+  const __m128 pz = _mm_set1_ps(p.z);
+  const __m128 r2 = _mm_set1_ps(R2);
+  for(; i+4<=cnt; i+=4) {
+    __m128 dx = _mm_sub_ps(_mm_loadu_ps(x+i),px);
+    __m128 dy = _mm_sub_ps(_mm_loadu_ps(y+i),py);
+    __m128 dz = _mm_sub_ps(_mm_loadu_ps(z+i),pz);
+    __m128 d2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx,dx),_mm_mul_ps(dy,dy)),_mm_mul_ps(dz,dz));
+    int    m  = _mm_movemask_ps(_mm_cmple_ps(d2,r2));
+    for(size_t b=0; m!=0; ++b, m>>=1)
+      if(m&1)
+        func(i+b);
+    }
+#endif
+  for(; i<cnt; ++i) {
+    float dx = x[i]-p.x, dy = y[i]-p.y, dz = z[i]-p.z;
+    if(dx*dx+dy*dy+dz*dz<=R2)
+      func(i);
+    }
+  }
+
+bool BaseSpaceIndex::Node::isLeaf() const {
+  for(auto i:child)
+    if(i!=NoNode)
+      return false;
+  return true;
+  }
+
+bool BaseSpaceIndex::Node::contains(const Tempest::Vec3& p) const {
+  return std::abs(p.x-center.x)<=half &&
+         std::abs(p.y-center.y)<=half &&
+         std::abs(p.z-center.z)<=half;
   }
 
-void BaseSpaceIndex::invalidate() {
-  index.clear();
-  dynamic.clear();
+bool BaseSpaceIndex::Node::intersects(const Tempest::Vec3& p, float R) const {
+  float dx = std::max(std::abs(p.x-center.x)-half, 0.f);
+  float dy = std::max(std::abs(p.y-center.y)-half, 0.f);
+  float dz = std::max(std::abs(p.z-center.z)-half, 0.f);
+  return dx*dx+dy*dy+dz*dz<=R*R;
+  }
+
+void BaseSpaceIndex::clear() {
+  arr.clear();
+  pos.clear();
+  node.clear();
+  slot.clear();
+  handle.clear();
+  nodes.clear();
+  root = NoNode;
   }
 
 void BaseSpaceIndex::add(Vob* v) {
-  arr.push_back(v);
-  index.reserve(arr.size());
-  index.clear();
-  dynamic.clear();
+  if(handle.find(v)!=handle.end())
+    return;
+  uint32_t id = uint32_t(arr.size());
+  arr .push_back(v);
+  pos .push_back(v->position());
+  node.push_back(NoNode);
+  slot.push_back(0);
+  handle[v] = id;
+  insert(id);
   }
 
 void BaseSpaceIndex::del(Vob* v) {
-  for(size_t i=0;i<arr.size();++i) {
-    if(arr[i]==v) {
-      arr[i] = arr.back();
-      arr.pop_back();
-      index.clear();
-      dynamic.clear();
-      return;
-      }
+  auto it = handle.find(v);
+  if(it==handle.end())
+    return;
+  uint32_t id   = it->second;
+  uint32_t last = uint32_t(arr.size()-1);
+  handle.erase(it);
+  detach(id);
+
+  if(id!=last) {
+    arr [id] = arr [last];
+    pos [id] = pos [last];
+    node[id] = node[last];
+    slot[id] = slot[last];
+    nodes[node[id]].obj[slot[id]] = id;
+    handle[arr[id]] = id;
+    }
+  arr .pop_back();
+  pos .pop_back();
+  node.pop_back();
+  slot.pop_back();
+  }
+
+void BaseSpaceIndex::update(const Vob* v) {
+  auto it = handle.find(v);
+  if(it==handle.end())
+    return;
+  uint32_t id = it->second;
+  auto     p  = v->position();
+  if(p==pos[id])
+    return;
+  pos[id] = p;
+
+  auto& n = nodes[node[id]];
+  if(n.isLeaf() && n.contains(p)) {
+    n.x[slot[id]] = p.x;
+    n.y[slot[id]] = p.y;
+    n.z[slot[id]] = p.z;
+    return;
     }
+  detach(id);
+  insert(id);
   }
 
 bool BaseSpaceIndex::hasObject(const Vob* v) const {
   if(v==nullptr)
     return false;
-  for(size_t i=0;i<arr.size();++i)
-    if(arr[i]==v)
-      return true;
-  return false;
+  return handle.find(v)!=handle.end();
   }
 
 void BaseSpaceIndex::find(const Tempest::Vec3& p, float R, const void* ctx, void (*func)(const void*, Vob*)) {
-  if(index.size()==0)
-    buildIndex();
-  for(auto& i:dynamic)
-    (*func)(ctx,i);
-  implFind(index.data(),index.size(),0,p,R,ctx,func);
-  }
-
-void BaseSpaceIndex::buildIndex() {
-  size_t cnt = 0;
-  index.resize(arr.size());
-  dynamic.clear();
-  for(size_t i=0; i<arr.size(); ++i) {
-    if(arr[i]->isDynamic()) {
-      dynamic.push_back(arr[i]);
-      } else {
-      index[cnt] = arr[i];
-      ++cnt;
-      }
-    }
-  index.resize(cnt);
-  buildIndex(index.data(),index.size(),0);
+  if(root==NoNode)
+    return;
+  implFind(root,p,R,ctx,func);
   }
 
-void BaseSpaceIndex::buildIndex(Vob** v, size_t cnt, uint8_t depth) {
-  depth%=3;
-  sort(v,cnt,depth);
-  size_t mid = cnt/2;
-  if(mid>0) {
-    // [0..mid)
-    buildIndex(v,mid,uint8_t(depth+1u));
+void BaseSpaceIndex::find(const Tempest::Vec3* p, const float* R, size_t cnt,
+                          std::vector<uint32_t>& offset, std::vector<Vob*>& hit) {
+  offset.assign(cnt+1,0);
+  hit.clear();
+  if(root==NoNode || cnt==0)
+    return;
+
+  // single tree walk for all queries
+  batchHits.clear();
+  batchQueries.resize(cnt);
+  for(size_t i=0; i<cnt; ++i)
+    batchQueries[i] = uint32_t(i);
+  implFind(root,p,R,0,cnt);
+
+  for(auto& h:batchHits)
+    offset[h.query+1]++;
+  for(size_t i=0; i<cnt; ++i)
+    offset[i+1] += offset[i];
+  hit.resize(batchHits.size());
+  batchQueries.assign(offset.begin(),offset.end()-1);
+  for(auto& h:batchHits) {
+    hit[batchQueries[h.query]] = arr[h.obj];
+    batchQueries[h.query]++;
     }
-  if(mid+1<cnt) {
-    // (mid..cnt)
-    buildIndex(v+mid+1,cnt-mid-1,uint8_t(depth+1u));
+  }
+
+uint32_t BaseSpaceIndex::mkNode(const Tempest::Vec3& center, float half) {
+  nodes.emplace_back();
+  auto& n  = nodes.back();
+  n.center = center;
+  n.half   = half;
+  return uint32_t(nodes.size()-1);
+  }
+
+uint32_t BaseSpaceIndex::mkChild(uint32_t parent, uint8_t oct) {
+  auto     c    = nodes[parent].center;
+  float    half = nodes[parent].half*0.5f;
+  c.x += (oct&1) ? half : -half;
+  c.y += (oct&2) ? half : -half;
+  c.z += (oct&4) ? half : -half;
+  uint32_t id = mkNode(c,half);
+  nodes[parent].child[oct] = id;
+  return id;
+  }
+
+uint8_t BaseSpaceIndex::octant(const Node& n, const Tempest::Vec3& p) {
+  uint8_t oct = 0;
+  if(p.x>=n.center.x)
+    oct |= 1;
+  if(p.y>=n.center.y)
+    oct |= 2;
+  if(p.z>=n.center.z)
+    oct |= 4;
+  return oct;
+  }
+
+void BaseSpaceIndex::growRoot(const Tempest::Vec3& p) {
+  auto  c    = nodes[root].center;
+  float half = nodes[root].half;
+  c.x += (p.x>=c.x) ? half : -half;
+  c.y += (p.y>=c.y) ? half : -half;
+  c.z += (p.z>=c.z) ? half : -half;
+
+  uint32_t prev = root;
+  root = mkNode(c,half*2.f);
+  nodes[root].child[octant(nodes[root],nodes[prev].center)] = prev;
+  }
+
+void BaseSpaceIndex::split(uint32_t n) {
+  auto obj = std::move(nodes[n].obj);
+  nodes[n].obj.clear();
+  nodes[n].x.clear();
+  nodes[n].y.clear();
+  nodes[n].z.clear();
+  for(auto id:obj) {
+    uint8_t  oct = octant(nodes[n],pos[id]);
+    uint32_t ch  = nodes[n].child[oct];
+    if(ch==NoNode)
+      ch = mkChild(n,oct);
+    attach(ch,id);
     }
   }
 
-void BaseSpaceIndex::sort(Vob** v, size_t cnt, uint8_t component) {
-  bool (*predicate)(const Vob* a, const Vob* b) = nullptr;
-  switch(component) {
-    case 0:
-      predicate = [](const Vob* a, const Vob* b){ return a->position().x < b->position().x; };
-      break;
-    case 1:
-      predicate = [](const Vob* a, const Vob* b){ return a->position().y < b->position().y; };
-      break;
-    case 2:
-      predicate = [](const Vob* a, const Vob* b){ return a->position().z < b->position().z; };
-      break;
+void BaseSpaceIndex::insert(uint32_t id) {
+  auto& p      = pos[id];
+  bool  finite = std::isfinite(p.x) && std::isfinite(p.y) && std::isfinite(p.z);
+  if(root==NoNode)
+    root = mkNode(finite ? p : Tempest::Vec3(),RootHalfSize);
+
+  if(!finite) {
+    // broken transform - keep at top level
+    attach(root,id);
+    return;
+    }
+
+  while(!nodes[root].contains(p))
+    growRoot(p);
+
+  uint32_t n = root;
+  while(true) {
+    if(nodes[n].isLeaf()) {
+      if(nodes[n].obj.size()<LeafSize || nodes[n].half<=MinHalfSize) {
+        attach(n,id);
+        return;
+        }
+      split(n);
+      }
+    uint8_t  oct = octant(nodes[n],p);
+    uint32_t ch  = nodes[n].child[oct];
+    if(ch==NoNode)
+      ch = mkChild(n,oct);
+    n = ch;
     }
-  std::sort(v,v+cnt,predicate);
   }
 
-void BaseSpaceIndex::implFind(Vob** v, size_t cnt, uint8_t depth,
-                              const Tempest::Vec3& p, float R, const void* ctx, void (*func)(const void*, Vob*)) {
-  if(cnt==0)
+void BaseSpaceIndex::attach(uint32_t n, uint32_t id) {
+  auto& nd = nodes[n];
+  node[id] = n;
+  slot[id] = uint32_t(nd.obj.size());
+  nd.obj.push_back(id);
+  nd.x.push_back(pos[id].x);
+  nd.y.push_back(pos[id].y);
+  nd.z.push_back(pos[id].z);
+  }
+
+void BaseSpaceIndex::detach(uint32_t id) {
+  auto&    nd   = nodes[node[id]];
+  uint32_t s    = slot[id];
+  uint32_t last = nd.obj.back();
+  nd.obj[s]  = last;
+  nd.x[s]    = nd.x.back();
+  nd.y[s]    = nd.y.back();
+  nd.z[s]    = nd.z.back();
+  slot[last] = s;
+  nd.obj.pop_back();
+  nd.x.pop_back();
+  nd.y.pop_back();
+  nd.z.pop_back();
+  node[id] = NoNode;
+  }
+
+void BaseSpaceIndex::implFind(uint32_t n, const Tempest::Vec3& p, float R, const void* ctx, void (*func)(const void*, Vob*)) {
+  auto& nd = nodes[n];
+  if(!nd.intersects(p,R))
     return;
 
-  auto mid = cnt/2;
-  auto pos = v[mid]->position();
+  sphereTest(nd.x.data(),nd.y.data(),nd.z.data(),nd.obj.size(),p,R,[&](size_t i){
+    func(ctx,arr[nd.obj[i]]);
+    });
+  for(auto ch:nd.child)
+    if(ch!=NoNode)
+      implFind(ch,p,R,ctx,func);
+  }
 
-  if((pos-p).quadLength()<=R*R) {
-    func(ctx,v[mid]);
+void BaseSpaceIndex::implFind(uint32_t n, const Tempest::Vec3* p, const float* R, size_t qBegin, size_t qEnd) {
+  // queries, that touch this node, are appended to the end of 'batchQueries'
+  const size_t begin = batchQueries.size();
+  for(size_t i=qBegin; i<qEnd; ++i) {
+    uint32_t q = batchQueries[i];
+    if(nodes[n].intersects(p[q],R[q]))
+      batchQueries.push_back(q);
     }
+  const size_t end = batchQueries.size();
+  if(begin==end)
+    return;
 
-  depth%=3;
-  switch(depth) {
-    case 0:
-      if(p.x-R<=pos.x)
-        implFind(v,mid,uint8_t(depth+1u),p,R, ctx,func);
-      if(p.x+R>=pos.x)
-        implFind(v+mid+1,cnt-mid-1,uint8_t(depth+1u),p,R, ctx,func);
-      break;
-    case 1:
-      if(p.y-R<=pos.y)
-        implFind(v,mid,uint8_t(depth+1u),p,R, ctx,func);
-      if(p.y+R>=pos.y)
-        implFind(v+mid+1,cnt-mid-1,uint8_t(depth+1u),p,R, ctx,func);
-      break;
-    case 2:
-      if(p.z-R<=pos.z)
-        implFind(v,mid,uint8_t(depth+1u),p,R, ctx,func);
-      if(p.z+R>=pos.z)
-        implFind(v+mid+1,cnt-mid-1,uint8_t(depth+1u),p,R, ctx,func);
-      break;
+  auto& nd = nodes[n];
+  for(size_t i=begin; i<end; ++i) {
+    uint32_t q = batchQueries[i];
+    sphereTest(nd.x.data(),nd.y.data(),nd.z.data(),nd.obj.size(),p[q],R[q],[&](size_t id){
+      batchHits.push_back(QueryHit{q,nd.obj[id]});
+      });
     }
+
+  for(auto ch:nd.child)
+    if(ch!=NoNode)
+      implFind(ch,p,R,begin,end);
+  batchQueries.resize(begin);
   }
@@ -5,6 +5,7 @@
 #include <algorithm>
 #include <array>
 #include <memory>
+#include <unordered_map>
 #include <Tempest/Point>
 
 #include "utils/workers.h"
@@ -15,7 +16,7 @@ class BaseSpaceIndex {
   public:
     void   clear();
     size_t size() const { return arr.size(); }
-    void   invalidate();
+    void   update(const Vob* v);
 
   protected:
     BaseSpaceIndex() = default;
@@ -24,20 +25,65 @@ class BaseSpaceIndex {
     bool               hasObject(const Vob* v) const;
 
     void               find(const Tempest::Vec3& p, float R, const void* ctx, void (*func)(const void*, Vob*));
+    void               find(const Tempest::Vec3* p, const float* R, size_t cnt, std::vector<uint32_t>& offset, std::vector<Vob*>& hit);
     template<class Func>
     void               parallelFor(Func f);
     Vob**              data() { return arr.data(); }
     Vob*const*         data() const { return arr.data(); }
 
   private:
-    std::vector<Vob*>  arr;
-    std::vector<Vob*>  index;
-    std::vector<Vob*>  dynamic;
-
-    void               buildIndex();
-    void               buildIndex(Vob** v, size_t cnt, uint8_t depth);
-    void               sort(Vob** v, size_t cnt, uint8_t component);
-    void               implFind(Vob** v, size_t cnt, uint8_t depth, const Tempest::Vec3& p, float R, const void* ctx, void(*func)(const void*, Vob*));
+    enum : uint32_t {
+      NoNode   = uint32_t(-1),
+      LeafSize = 16,
+      };
+    static constexpr float MinHalfSize  = 64.f;
+    static constexpr float RootHalfSize = 4096.f;
+
+    struct Node {
+      Tempest::Vec3         center;
+      float                 half = 0;
+      uint32_t              child[8] = {NoNode,NoNode,NoNode,NoNode,NoNode,NoNode,NoNode,NoNode};
+      std::vector<uint32_t> obj;
+      // SoA copy of object positions, for vectorized tests
+      std::vector<float>    x, y, z;
+
+      bool isLeaf() const;
+      bool contains(const Tempest::Vec3& p) const;
+      bool intersects(const Tempest::Vec3& p, float R) const;
+      };
+
+    struct QueryHit {
+      uint32_t query;
+      uint32_t obj;
+      };
+
+    // dense object list; index in 'arr' is object handle
+    std::vector<Vob*>                        arr;
+    std::vector<Tempest::Vec3>               pos;
+    std::vector<uint32_t>                    node;
+    std::vector<uint32_t>                    slot;
+    std::unordered_map<const Vob*,uint32_t>  handle;
+
+    // point octree
+    std::vector<Node>                        nodes;
+    uint32_t                                 root = NoNode;
+
+    // scratch for batched queries
+    std::vector<uint32_t>                    batchQueries;
+    std::vector<QueryHit>                    batchHits;
+
+    uint32_t           mkNode(const Tempest::Vec3& center, float half);
+    uint32_t           mkChild(uint32_t parent, uint8_t oct);
+    static uint8_t     octant(const Node& n, const Tempest::Vec3& p);
+    void               growRoot(const Tempest::Vec3& p);
+    void               split(uint32_t n);
+
+    void               insert(uint32_t id);
+    void               attach(uint32_t n, uint32_t id);
+    void               detach(uint32_t id);
+
+    void               implFind(uint32_t n, const Tempest::Vec3& p, float R, const void* ctx, void(*func)(const void*, Vob*));
+    void               implFind(uint32_t n, const Tempest::Vec3* p, const float* R, size_t qBegin, size_t qEnd);
   };
 
 template<class Func>
@@ -77,9 +123,25 @@ class SpaceIndex final : public BaseSpaceIndex {
         });
       }
 
+    // hits of query 'i' are stored in [begin(i)..end(i))
+    class Batch {
+      public:
+        size_t    size() const              { return offset.empty() ? 0 : offset.size()-1; }
+        T*const*  begin(size_t query) const { return reinterpret_cast<T*const*>(hit.data()+offset[query]);   }
+        T*const*  end  (size_t query) const { return reinterpret_cast<T*const*>(hit.data()+offset[query+1]); }
+
+      private:
+        std::vector<uint32_t> offset;
+        std::vector<Vob*>     hit;
+      friend class SpaceIndex;
+      };
+
+    void find(const Tempest::Vec3* p, const float* R, size_t cnt, Batch& out) {
+      BaseSpaceIndex::find(p,R,cnt,out.offset,out.hit);
+      }
+
     template<class F>
     void parallelFor(F func) {
       BaseSpaceIndex::parallelFor([&func](Vob* v){ func(*reinterpret_cast<T*>(v)); });
       }
   };
-
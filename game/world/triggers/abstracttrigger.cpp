@@ -1,5 +1,7 @@
 #include "abstracttrigger.h"
 
+#include <algorithm>
+
 #include <Tempest/Log>
 
 #include "world/objects/npc.h"
@@ -49,8 +51,11 @@ void AbstractTrigger::processOnStart(const TriggerEvent& evt) {
   }
 
 void AbstractTrigger::processEvent(const TriggerEvent& evt) {
-  if(emitTimeLast>0 && world.tickCount()<emitTimeLast+uint64_t(data.zCTrigger.fireDelaySec*1000.f)) {
-    world.triggerEvent(evt);
+  const uint64_t fireTime = emitTimeLast+uint64_t(data.zCTrigger.fireDelaySec*1000.f);
+  if(emitTimeLast>0 && world.tickCount()<fireTime) {
+    TriggerEvent ev = evt;
+    ev.timeBarrier = std::max(ev.timeBarrier,fireTime);
+    world.triggerEvent(ev);
     return;
     }
   emitTimeLast = world.tickCount();
@@ -166,13 +171,33 @@ void AbstractTrigger::load(Serialize& fin) {
   }
 
 void AbstractTrigger::enableTicks() {
+  wakeTime = 0;
   world.enableTicks(*this);
   }
 
+void AbstractTrigger::enableTicksAt(uint64_t time) {
+  // sleep until 'time': no per-frame tick in between
+  if(time<=world.tickCount()) {
+    enableTicks();
+    return;
+    }
+  world.disableTicks(*this);
+  wakeTime = time;
+  world.scheduleTicks(*this,time);
+  }
+
 void AbstractTrigger::disableTicks() {
+  wakeTime = 0;
   world.disableTicks(*this);
   }
 
+void AbstractTrigger::wake(uint64_t time) {
+  // stale wake-up, if trigger was rescheduled or enabled meanwhile
+  if(wakeTime!=time)
+    return;
+  enableTicks();
+  }
+
 const std::vector<Npc*>& AbstractTrigger::intersections() const {
   return boxNpc.intersections();
   }
@@ -192,6 +217,7 @@ void TriggerEvent::save(Serialize& fout) const {
 
 void TriggerEvent::load(Serialize& fin) {
   fin.read(target,emitter,reinterpret_cast<uint8_t&>(type),timeBarrier);
+  targetId = StrId(target);
   if(type==T_Move)
     fin.read(reinterpret_cast<uint8_t&>(move.msg),move.key);
   }
@@ -6,6 +6,7 @@
 #include "world/objects/vob.h"
 #include "world/collisionzone.h"
 #include "physics/dynamicworld.h"
+#include "utils/strid.h"
 
 class Npc;
 class World;
@@ -25,14 +26,16 @@ class TriggerEvent final {
       };
 
     TriggerEvent()=default;
-    TriggerEvent(std::string target, std::string emitter, Type type):target(std::move(target)), emitter(std::move(emitter)), type(type){}
+    TriggerEvent(std::string target, std::string emitter, Type type)
+      :target(std::move(target)), targetId(this->target), emitter(std::move(emitter)), type(type){}
     TriggerEvent(std::string target, std::string emitter, uint64_t t, Type type)
-      :target(std::move(target)), emitter(std::move(emitter)),type(type),timeBarrier(t){}
+      :target(std::move(target)), targetId(this->target), emitter(std::move(emitter)),type(type),timeBarrier(t){}
 
     void              save(Serialize& fout) const;
     void              load(Serialize &fin);
 
     std::string       target;
+    StrId             targetId; // resolved once: event may be delayed and re-queued many times
     std::string       emitter;
     Type              type        = T_Trigger;
     uint64_t          timeBarrier = 0;
@@ -55,6 +58,7 @@ class AbstractTrigger : public Vob {
     void                         processEvent(const TriggerEvent& evt);
     virtual void                 onIntersect(Npc& n);
     virtual void                 tick(uint64_t dt);
+    void                         wake(uint64_t time);
 
     virtual bool                 hasVolume() const;
     bool                         checkPos(const Tempest::Vec3& pos) const;
@@ -89,6 +93,7 @@ class AbstractTrigger : public Vob {
     bool                         hasFlag(ReactFlg flg) const;
 
     void                         enableTicks();
+    void                         enableTicksAt(uint64_t time);
     void                         disableTicks();
     const std::vector<Npc*>&     intersections() const;
 
@@ -101,4 +106,5 @@ class AbstractTrigger : public Vob {
     uint32_t                     emitCount = 0;
     bool                         disabled  = false;
     uint64_t                     emitTimeLast = 0;
+    uint64_t                     wakeTime     = 0;
   };
@@ -177,9 +177,12 @@ void MoveTrigger::tick(uint64_t /*dt*/) {
     case Idle:
       break;
     case OpenTimed: {
-      if(sAnim+uint64_t(mover.stayOpenTimeSec*1000)<world.tickCount()) {
+      const uint64_t closeTime = sAnim+uint64_t(mover.stayOpenTimeSec*1000);
+      if(closeTime<world.tickCount()) {
         state = Close;
         sAnim = world.tickCount();
+        } else {
+        enableTicksAt(closeTime+1);
         }
       return;
       }
@@ -250,7 +253,7 @@ void MoveTrigger::tick(uint64_t /*dt*/) {
     if(data.zCMover.moverBehavior==ZenLoad::MoverBehavior::STATE_OPEN_TIMED && prev==Open) {
       state = OpenTimed;
       sAnim = world.tickCount();
-      enableTicks();
+      enableTicksAt(sAnim+uint64_t(data.zCMover.stayOpenTimeSec*1000)+1);
       }
     emitSound(snd);
     } else {
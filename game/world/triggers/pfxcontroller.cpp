@@ -60,5 +60,7 @@ void PfxController::tick(uint64_t /*dt*/) {
   if(killed<world.tickCount()) {
     disableTicks();
     pfx.setActive(false);
+    } else {
+    enableTicksAt(killed+1);
     }
   }
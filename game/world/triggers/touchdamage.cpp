@@ -16,8 +16,15 @@ void TouchDamage::onTrigger(const TriggerEvent&/*evt*/) {
 void TouchDamage::tick(uint64_t dt) {
   AbstractTrigger::tick(dt);
 
-  if(world.tickCount()<=repeatTimeout)
+  if(world.tickCount()<=repeatTimeout) {
+    enableTicksAt(repeatTimeout+1);
     return;
+    }
+  if(intersections().empty()) {
+    // re-enabled by onIntersect
+    disableTicks();
+    return;
+    }
 
   for(auto npc:intersections()) {
     bool mask[Daedalus::GEngineClasses::PROT_INDEX_MAX] = {};
@@ -39,6 +46,7 @@ void TouchDamage::tick(uint64_t dt) {
     }
 
   repeatTimeout = world.tickCount() + uint64_t(data.oCTouchDamage.damageRepeatDelaySec*1000);
+  enableTicksAt(repeatTimeout+1);
   }
 
 void TouchDamage::takeDamage(Npc& npc, int32_t val, int32_t prot) {
@@ -2,6 +2,7 @@
 
 #include <Tempest/Log>
 #include <algorithm>
+#include <cmath>
 #include <limits>
 
 #include "game/movealgo.h"
@@ -12,6 +13,112 @@
 
 using namespace Tempest;
 
+static const float   ClusterSize = 40.f*100.f;
+static const float   CorridorMin = 2.f*ClusterSize;
+static const uint32_t NotInHeap   = uint32_t(-1);
+
+// Euclidean distance, slightly deflated: edge lengths are truncated to integer
+static int32_t heuristic(const Vec3& a, const Vec3& b) {
+  return int32_t(std::sqrt((a-b).quadLength())*0.99f);
+  }
+
+template<class State>
+static void heapUp(State& st, uint32_t i) {
+  auto& heap = st.heap;
+  auto& node = st.node;
+  uint32_t id = heap[i];
+  while(i>0) {
+    uint32_t p = (i-1)/2;
+    if(node[heap[p]].f<=node[id].f)
+      break;
+    heap[i] = heap[p];
+    node[heap[i]].heapId = i;
+    i = p;
+    }
+  heap[i] = id;
+  node[id].heapId = i;
+  }
+
+template<class State>
+static uint32_t heapPop(State& st) {
+  auto&    heap = st.heap;
+  auto&    node = st.node;
+  uint32_t ret  = heap[0];
+  uint32_t id   = heap.back();
+  heap.pop_back();
+  node[ret].heapId = NotInHeap;
+  if(heap.empty())
+    return ret;
+
+  uint32_t i = 0, sz = uint32_t(heap.size());
+  while(true) {
+    uint32_t c = i*2+1;
+    if(c>=sz)
+      break;
+    if(c+1<sz && node[heap[c+1]].f<node[heap[c]].f)
+      ++c;
+    if(node[id].f<=node[heap[c]].f)
+      break;
+    heap[i] = heap[c];
+    node[heap[i]].heapId = i;
+    i = c;
+    }
+  heap[i] = id;
+  node[id].heapId = i;
+  return ret;
+  }
+
+// A* over indexed graph; neighbors(u,visit) must call visit(v,len) for every edge
+template<class State, class Neighbors, class Heuristic>
+static bool aStar(State& st, size_t count, uint32_t begin, uint32_t end, const Neighbors& neighbors, const Heuristic& h) {
+  if(st.node.size()!=count) {
+    st.node.assign(count,{});
+    st.gen = 0;
+    }
+  st.gen++;
+  if(st.gen==0) {
+    // new cycle
+    for(auto& i:st.node)
+      i.gen = 0;
+    st.gen = 1;
+    }
+  st.heap.clear();
+
+  auto& b  = st.node[begin];
+  b.g      = 0;
+  b.f      = h(begin);
+  b.parent = begin;
+  b.gen    = st.gen;
+  st.heap.push_back(begin);
+  b.heapId = 0;
+
+  while(!st.heap.empty()) {
+    uint32_t u = heapPop(st);
+    if(u==end)
+      return true;
+    const int32_t g0 = st.node[u].g;
+    neighbors(u,[&](uint32_t v, int32_t len) {
+      auto&   n = st.node[v];
+      int32_t g = g0+len;
+      if(n.gen!=st.gen) {
+        n.gen    = st.gen;
+        n.heapId = NotInHeap;
+        } else if(n.g<=g) {
+        return;
+        }
+      n.g      = g;
+      n.f      = g+h(v);
+      n.parent = u;
+      if(n.heapId==NotInHeap) {
+        n.heapId = uint32_t(st.heap.size());
+        st.heap.push_back(v);
+        }
+      heapUp(st,n.heapId);
+      });
+    }
+  return false;
+  }
+
 WayMatrix::WayMatrix(World &world, const ZenLoad::zCWayNetData &dat)
   :world(world) {
   // scripting doc says 20m, but number seems to be incorrect
@@ -32,9 +139,6 @@ WayMatrix::WayMatrix(World &world, const ZenLoad::zCWayNetData &dat)
   for(auto& i:wayPoints)
     if(i.name.find("START")!=std::string::npos)
       startPoints.push_back(i);
-
-  stk[0].reserve(256);
-  stk[1].reserve(256);
   }
 
 void WayMatrix::buildIndex() {
@@ -46,11 +150,17 @@ void WayMatrix::buildIndex() {
     return a->name<b->name;
     });
 
-  for(auto& i:freePoints)
-    fpInd.push_back(&i);
-  std::sort(fpInd.begin(),fpInd.end(),[](const WayPoint* a,const WayPoint* b){
-    return a->x<b->x;
-    });
+  pointByName.clear();
+  for(auto& i:startPoints)
+    pointByName.emplace(StrId(i.name.c_str()),&i);
+  for(auto i:indexPoints)
+    pointByName.emplace(StrId(i->name.c_str()),i);
+
+  std::vector<const WayPoint*> pt;
+  for(auto& i:wayPoints)
+    pt.push_back(&i);
+  wpGrid.build(std::move(pt),distanceThreshold);
+  indexGrid.build(std::vector<const WayPoint*>(indexPoints.begin(),indexPoints.end()),distanceThreshold);
 
   for(auto& i:edges){
     if(i.first<wayPoints.size() && i.second<wayPoints.size()){
@@ -61,50 +171,193 @@ void WayMatrix::buildIndex() {
       b.connect(a);
       }
     }
+  buildClusters();
   }
 
-const WayPoint *WayMatrix::findWayPoint(const Vec3& at, const Vec3& to, const std::function<bool(const WayPoint&)>& filter) const {
-  const WayPoint* ret =nullptr;
-  float           dist=std::numeric_limits<float>::max();
-  for(auto& w:wayPoints) {
-    if(!filter(w))
+void WayMatrix::buildClusters() {
+  clusters.clear();
+  clusterOf.assign(wayPoints.size(),uint32_t(-1));
+
+  auto cell = [](const WayPoint& w) {
+    return std::make_pair(int32_t(std::floor(w.x/ClusterSize)),int32_t(std::floor(w.z/ClusterSize)));
+    };
+
+  // connected components of waypoints within same grid cell
+  std::vector<uint32_t> stk;
+  for(size_t i=0; i<wayPoints.size(); ++i) {
+    if(clusterOf[i]!=uint32_t(-1))
       continue;
-    auto  dp0 = at-w.position();
-    float l0  = dp0.quadLength();
+    const uint32_t id = uint32_t(clusters.size());
+    const auto     c  = cell(wayPoints[i]);
+    clusters.emplace_back();
+    auto&          cl = clusters.back();
+    size_t         n  = 0;
+
+    clusterOf[i] = id;
+    stk.push_back(uint32_t(i));
+    while(!stk.empty()) {
+      auto& w = wayPoints[stk.back()];
+      stk.pop_back();
+      cl.pos += w.position();
+      ++n;
+      for(auto& e:w.connections()) {
+        size_t j = size_t(std::distance<const WayPoint*>(wayPoints.data(),e.point));
+        if(clusterOf[j]==uint32_t(-1) && cell(wayPoints[j])==c) {
+          clusterOf[j] = id;
+          stk.push_back(uint32_t(j));
+          }
+        }
+      }
+    cl.pos /= float(n);
+    }
+
+  for(size_t i=0; i<wayPoints.size(); ++i) {
+    auto& a = clusters[clusterOf[i]];
+    for(auto& e:wayPoints[i].connections()) {
+      size_t   j  = size_t(std::distance<const WayPoint*>(wayPoints.data(),e.point));
+      uint32_t cb = clusterOf[j];
+      if(cb==clusterOf[i])
+        continue;
+      bool exists = false;
+      for(auto& l:a.link)
+        exists |= (l.id==cb);
+      if(exists)
+        continue;
+      Cluster::Link l;
+      l.id  = cb;
+      l.len = std::max(1,int32_t(std::sqrt((a.pos-clusters[cb].pos).quadLength())));
+      a.link.push_back(l);
+      }
+    }
+  }
+
+void WayMatrix::Grid::build(std::vector<const WayPoint*> pt, float cSize) {
+  cellSize = cSize;
+  points   = std::move(pt);
+  cells.clear();
+  minX = minZ = std::numeric_limits<int32_t>::max();
+  maxX = maxZ = std::numeric_limits<int32_t>::min();
+
+  auto key = [this](const WayPoint* w) {
+    return (uint64_t(uint32_t(cellOf(w->x)))<<32) | uint64_t(uint32_t(cellOf(w->z)));
+    };
+  std::sort(points.begin(),points.end(),[&key](const WayPoint* a, const WayPoint* b){
+    return key(a)<key(b);
+    });
+
+  for(size_t i=0; i<points.size(); ) {
+    size_t   b = i;
+    uint64_t k = key(points[i]);
+    while(i<points.size() && key(points[i])==k)
+      ++i;
+    cells[k] = std::make_pair(uint32_t(b),uint32_t(i));
+
+    int32_t x = cellOf(points[b]->x), z = cellOf(points[b]->z);
+    minX = std::min(minX,x);
+    maxX = std::max(maxX,x);
+    minZ = std::min(minZ,z);
+    maxZ = std::max(maxZ,z);
+    }
+  }
+
+int32_t WayMatrix::Grid::cellOf(float v) const {
+  float c = std::floor(v/cellSize);
+  c = std::max(c,-float(1<<29));
+  c = std::min(c, float(1<<29));
+  return int32_t(c);
+  }
+
+// Ring-search around 'at': cost must not be smaller, than squared distance in XZ plane.
+// Filter is called only for candidates, that are better than current best.
+template<class Cost, class Filter>
+const WayPoint* WayMatrix::Grid::nearest(const Vec3& at, float R, const Cost& cost, const Filter& filter) const {
+  if(points.empty())
+    return nullptr;
+
+  const int32_t cx = cellOf(at.x);
+  const int32_t cz = cellOf(at.z);
 
-    auto  dp1 = to-w.position();
-    float l1  = dp1.quadLength();
+  int32_t maxRing = std::max(std::max(std::abs(cx-minX),std::abs(cx-maxX)),
+                             std::max(std::abs(cz-minZ),std::abs(cz-maxZ)));
+  float   best    = std::numeric_limits<float>::max();
+  if(R<std::numeric_limits<float>::max()) {
+    maxRing = std::min(maxRing,int32_t(R/cellSize)+1);
+    best    = R*R;
+    }
+
+  const WayPoint* ret = nullptr;
+  auto visit = [&](int32_t x, int32_t z) {
+    if(x<minX || x>maxX || z<minZ || z>maxZ)
+      return;
+    auto it = cells.find((uint64_t(uint32_t(x))<<32) | uint64_t(uint32_t(z)));
+    if(it==cells.end())
+      return;
+    for(uint32_t i=it->second.first; i<it->second.second; ++i) {
+      auto& w = *points[i];
+      float l = cost(w);
+      if(l<best && filter(w)) {
+        ret  = &w;
+        best = l;
+        }
+      }
+    };
 
-    float l = l0 + std::min<float>(l1,150*150);
-    if(l<dist){
-      ret  = &w;
-      dist = l;
+  // first ring, that may overlap with grid bounds
+  int32_t minRing = std::max(std::max(minX-cx,cx-maxX),std::max(minZ-cz,cz-maxZ));
+  minRing = std::max(minRing,0);
+
+  for(int32_t r=minRing; r<=maxRing; ++r) {
+    if(r>0) {
+      float lb = float(r-1)*cellSize;
+      if(lb*lb>=best)
+        break;
+      }
+    if(r==0) {
+      visit(cx,cz);
+      continue;
+      }
+    for(int32_t x=std::max(cx-r,minX); x<=std::min(cx+r,maxX); ++x) {
+      visit(x,cz-r);
+      visit(x,cz+r);
+      }
+    for(int32_t z=std::max(cz-r+1,minZ); z<=std::min(cz+r-1,maxZ); ++z) {
+      visit(cx-r,z);
+      visit(cx+r,z);
       }
     }
   return ret;
   }
 
+const WayPoint *WayMatrix::findWayPoint(const Vec3& at, const Vec3& to, const std::function<bool(const WayPoint&)>& filter) const {
+  auto cost = [&at,&to](const WayPoint& w) {
+    float l0 = (at-w.position()).quadLength();
+    float l1 = (to-w.position()).quadLength();
+    return l0 + std::min<float>(l1,150*150);
+    };
+  return wpGrid.nearest(at,std::numeric_limits<float>::max(),cost,filter);
+  }
+
 const WayPoint *WayMatrix::findFreePoint(const Vec3& at, std::string_view name, const std::function<bool(const WayPoint&)>& filter) const {
+  return findFreePoint(at,StrId(name),filter);
+  }
+
+const WayPoint *WayMatrix::findFreePoint(const Vec3& at, StrId name, const std::function<bool(const WayPoint&)>& filter) const {
+  // empty name matches any free point, as in checkName
   auto&  index = findFpIndex(name);
-  return findFreePoint(at.x,at.y,at.z,index,filter);
+  return findFreePoint(at,index,filter);
   }
 
 const WayPoint *WayMatrix::findNextPoint(const Vec3& at) const {
-  const WayPoint* ret   = nullptr;
-  float           dist  = distanceThreshold;
-
-  dist*=dist;
-  for(auto pw:indexPoints){
-    auto& w  = *pw;
-    auto  dp = w.position()-at;
-    float l  = dp.quadLength();
-
-    if(l<dist && dp.z*dp.z<300*300 && !w.isLocked()){
-      ret  = &w;
-      dist = l;
-      }
-    }
-  return ret;
+  auto cost = [&at](const WayPoint& w) {
+    auto dp = w.position()-at;
+    if(dp.z*dp.z>=300*300)
+      return std::numeric_limits<float>::max();
+    return dp.quadLength();
+    };
+  auto filter = [](const WayPoint& w) {
+    return !w.isLocked();
+    };
+  return indexGrid.nearest(at,distanceThreshold,cost,filter);
   }
 
 void WayMatrix::addFreePoint(const Vec3& pos, const Vec3& dir, std::string_view name) {
@@ -133,14 +386,9 @@ const WayPoint &WayMatrix::startPoint() const {
 const WayPoint* WayMatrix::findPoint(std::string_view name, bool inexact) const {
   if(name.empty())
     return nullptr;
-  for(auto& i:startPoints)
-    if(name==i.name.c_str())
-      return &i;
-  auto it = std::lower_bound(indexPoints.begin(),indexPoints.end(),name,[](const WayPoint* a, std::string_view b){
-      return a->name.c_str()<b;
-    });
-  if(it!=indexPoints.end() && name==(*it)->name.c_str())
-    return *it;
+  // names of all points are interned in buildIndex: unknown id means no exact match
+  if(auto id = StrId::find(name); !id.isEmpty())
+    return findPoint(id,inexact);
   if(!inexact)
     return nullptr;
   for(auto i:indexPoints)
@@ -149,6 +397,21 @@ const WayPoint* WayMatrix::findPoint(std::string_view name, bool inexact) const
   return nullptr;
   }
 
+const WayPoint* WayMatrix::findPoint(StrId name, bool inexact) const {
+  if(name.isEmpty())
+    return nullptr;
+  auto it = pointByName.find(name);
+  if(it!=pointByName.end())
+    return it->second;
+  if(!inexact)
+    return nullptr;
+  const auto str = name.str();
+  for(auto i:indexPoints)
+    if(i->checkName(str))
+      return i;
+  return nullptr;
+  }
+
 void WayMatrix::marchPoints(DbgPainter &p) const {
   static bool ddraw=false;
   if(!ddraw)
@@ -172,67 +435,106 @@ void WayMatrix::marchPoints(DbgPainter &p) const {
   }
 
 void WayMatrix::adjustWaypoints(std::vector<WayPoint> &wp) {
-  for(auto& w:wp) {
-    w.y = world.physic()->landRay(w.position()).v.y;
+  DynamicWorld::RayBatch rb;
+  for(auto& w:wp)
+    rb.addLand(w.position());
+  world.physic()->rayBatch(rb);
+
+  for(size_t i=0; i<wp.size(); ++i) {
+    auto& w = wp[i];
+    w.y = rb.v[i].y;
     indexPoints.push_back(&w);
     }
   }
 
-const WayMatrix::FpIndex &WayMatrix::findFpIndex(std::string_view name) const {
-  auto it = std::lower_bound(fpIndex.begin(),fpIndex.end(),name,[](FpIndex& l, std::string_view r){
-    return l.key<r;
+const WayMatrix::FpIndex &WayMatrix::findFpIndex(StrId key) const {
+  std::lock_guard<std::mutex> guard(fpSync);
+  auto it = std::lower_bound(fpIndex.begin(),fpIndex.end(),key,[](const std::unique_ptr<FpIndex>& l, StrId r){
+    return l->key<r;
     });
-  if(it!=fpIndex.end() && it->key==name){
-    return *it;
+  if(it!=fpIndex.end() && (*it)->key==key){
+    return **it;
     }
 
-  FpIndex id;
-  id.key = name;
+  std::unique_ptr<FpIndex> id(new FpIndex());
+  id->key = key;
+  const auto name = key.str();
+  std::vector<const WayPoint*> pt;
   for(auto& w:freePoints){
     if(!w.checkName(name))
       continue;
-    id.index.push_back(&w);
+    pt.push_back(&w);
     }
-  // TODO: good index, not sort by 'x' :)
-  std::sort(id.index.begin(),id.index.end(),[](const WayPoint* a,const WayPoint* b){
-    return a->x<b->x;
-    });
+  id->index.build(std::move(pt),distanceThreshold);
 
   it = fpIndex.insert(it,std::move(id));
-  return *it;
+  return **it;
   }
 
-const WayPoint *WayMatrix::findFreePoint(float x, float y, float z, const FpIndex& ind,
+const WayPoint *WayMatrix::findFreePoint(const Vec3& at, const FpIndex& ind,
                                          const std::function<bool(const WayPoint&)>& filter) const {
-  float R = distanceThreshold;
-  auto b = std::lower_bound(ind.index.begin(),ind.index.end(), x-R ,[](const WayPoint *a, float b){
-    return a->x<b;
-    });
-  auto e = std::upper_bound(ind.index.begin(),ind.index.end(), x+R ,[](float a,const WayPoint *b){
-    return a<b->x;
-    });
+  auto cost = [&at](const WayPoint& w) {
+    auto dp = w.position()-at;
+    if(dp.z*dp.z>300*300)
+      return std::numeric_limits<float>::max();
+    return dp.quadLength();
+    };
+  return ind.index.nearest(at,distanceThreshold,cost,filter);
+  }
 
-  const WayPoint* ret=nullptr;
-  auto  count = std::distance(b,e);(void) count;
-  float dist  = R*R;
-  for(auto i=b;i!=e;++i){
-    auto& w  = **i;
-    float dx = w.x-x;
-    float dy = w.y-y;
-    float dz = w.z-z;
-    float l  = dx*dx+dy*dy+dz*dz;
-    if(l>dist || dz*dz>300*300)
-      continue;
-    if(!filter(w))
-      continue;
-    ret  = &w;
-    dist = l;
-    }
+bool WayMatrix::PathRequest::isReady() const {
+  return task!=nullptr && task->ready.load(std::memory_order_acquire);
+  }
+
+WayMatrix::PathRequest WayMatrix::PathRequest::resolved(WayPath&& path) {
+  PathRequest ret;
+  ret.task       = std::make_shared<Task>();
+  ret.task->path = std::move(path);
+  ret.task->ready.store(true,std::memory_order_release);
+  return ret;
+  }
+
+WayPath WayMatrix::PathRequest::take() {
+  if(!isReady())
+    return WayPath();
+  auto ret = std::move(task->path);
+  task.reset();
   return ret;
   }
 
 WayPath WayMatrix::wayTo(const WayPoint& begin, const WayPoint& end) const {
-  intptr_t endId = std::distance<const WayPoint*>(&wayPoints[0],&end);
+  auto ctx = takeCtx();
+  auto ret = implWayTo(*ctx,begin,end);
+  releaseCtx(std::move(ctx));
+  return ret;
+  }
+
+WayMatrix::PathRequest WayMatrix::wayToAsync(const WayPoint& begin, const WayPoint& end) const {
+  PathRequest ret;
+  ret.task = std::make_shared<PathRequest::Task>();
+  Workers::spawn(pathAsync,[this,&begin,&end,task=ret.task](){
+    task->path = wayTo(begin,end);
+    task->ready.store(true,std::memory_order_release);
+    });
+  return ret;
+  }
+
+std::unique_ptr<WayMatrix::PathCtx> WayMatrix::takeCtx() const {
+  std::lock_guard<std::mutex> guard(pathSync);
+  if(pathCtx.empty())
+    return std::unique_ptr<PathCtx>(new PathCtx());
+  auto ret = std::move(pathCtx.back());
+  pathCtx.pop_back();
+  return ret;
+  }
+
+void WayMatrix::releaseCtx(std::unique_ptr<PathCtx>&& ctx) const {
+  std::lock_guard<std::mutex> guard(pathSync);
+  pathCtx.emplace_back(std::move(ctx));
+  }
+
+WayPath WayMatrix::implWayTo(PathCtx& ctx, const WayPoint& begin, const WayPoint& end) const {
+  intptr_t endId = std::distance<const WayPoint*>(wayPoints.data(),&end);
   if(endId<0 || size_t(endId)>=wayPoints.size()){
     if(end.name.find("FP_")==0) {
       WayPath ret;
@@ -242,57 +544,82 @@ WayPath WayMatrix::wayTo(const WayPoint& begin, const WayPoint& end) const {
     return WayPath();
     }
 
-  pathGen++;
-  if(pathGen==1){
-    // new cycle
-    for(auto& i:wayPoints)
-      i.pathGen=0;
+  WayPath ret;
+  ret.add(end);
+  if(&begin==&end)
+    return ret;
+
+  intptr_t beginId = std::distance<const WayPoint*>(wayPoints.data(),&begin);
+  if(beginId<0 || size_t(beginId)>=wayPoints.size())
+    return WayPath();
+
+  uint32_t b = uint32_t(beginId);
+  uint32_t e = uint32_t(endId);
+
+  bool found = false;
+  if((begin.position()-end.position()).quadLength()>CorridorMin*CorridorMin && findCorridor(ctx,b,e))
+    found = findPath(ctx,b,e,true);
+  if(!found)
+    found = findPath(ctx,b,e,false);
+  if(!found)
+    return WayPath();
+
+  for(uint32_t i=ctx.point.node[e].parent; ; i=ctx.point.node[i].parent) {
+    ret.add(wayPoints[i]);
+    if(i==b)
+      break;
     }
-  begin.pathLen = 0;
-  begin.pathGen = pathGen;
-
-  std::vector<const WayPoint*> *front=&stk[0], *back=&stk[1];
-  stk[0].clear();
-  stk[1].clear();
-
-  front->push_back(&begin);
-
-  while(end.pathGen!=pathGen && front->size()>0){
-    for(auto& wp:*front){
-      int32_t l0 = wp->pathLen;
-
-      for(auto i:wp->connections()){
-        auto& w  = *i.point;
-        int32_t l1 = l0+i.len;
-        if(w.pathGen!=pathGen || w.pathLen>l1){
-          w.pathLen = l1;
-          w.pathGen = pathGen;
-          back->push_back(&w);
-          }
-        }
-      }
-    std::swap(front,back);
-    back->clear();
+  return ret;
+  }
+
+bool WayMatrix::findCorridor(PathCtx& ctx, uint32_t begin, uint32_t end) const {
+  const uint32_t cb = clusterOf[begin];
+  const uint32_t ce = clusterOf[end];
+
+  auto h = [this,ce](uint32_t c) {
+    return heuristic(clusters[c].pos,clusters[ce].pos);
+    };
+  auto next = [this](uint32_t c, auto&& visit) {
+    for(auto& l:clusters[c].link)
+      visit(l.id,l.len);
+    };
+  if(!aStar(ctx.cluster,clusters.size(),cb,ce,next,h))
+    return false;
+
+  if(ctx.corridor.size()!=clusters.size()) {
+    ctx.corridor.assign(clusters.size(),0);
+    ctx.corridorGen = 0;
+    }
+  ctx.corridorGen++;
+  if(ctx.corridorGen==0) {
+    std::fill(ctx.corridor.begin(),ctx.corridor.end(),0);
+    ctx.corridorGen = 1;
     }
 
-  WayPath ret;
-  ret.add(end);
-  const WayPoint* current = &end;
-  while(current!=&begin) {
-    int32_t l0 = current->pathLen, l1=l0;
-
-    const WayPoint* next=nullptr;
-    for(auto i:current->connections()){
-      if(i.point->pathGen==pathGen && i.point->pathLen+i.len<=l0 && i.point->pathLen<l1){
-        next = i.point;
-        l1   = i.point->pathLen;
-        }
-      }
-    if(next==nullptr)
-      return WayPath();
-    ret.add(*next);
-    current=next;
+  // abstract path plus one ring of neighbours, to leave room for local detours
+  for(uint32_t c=ce; ; c=ctx.cluster.node[c].parent) {
+    ctx.corridor[c] = ctx.corridorGen;
+    for(auto& l:clusters[c].link)
+      ctx.corridor[l.id] = ctx.corridorGen;
+    if(c==cb)
+      break;
     }
+  return true;
+  }
 
-  return ret;
+bool WayMatrix::findPath(PathCtx& ctx, uint32_t begin, uint32_t end, bool useCorridor) const {
+  const Vec3 dest = wayPoints[end].position();
+
+  auto h = [this,&dest](uint32_t i) {
+    return heuristic(wayPoints[i].position(),dest);
+    };
+  auto next = [this,&ctx,useCorridor](uint32_t i, auto&& visit) {
+    for(auto& c:wayPoints[i].connections()) {
+      uint32_t id = uint32_t(std::distance<const WayPoint*>(wayPoints.data(),c.point));
+      if(useCorridor && ctx.corridor[clusterOf[id]]!=ctx.corridorGen)
+        continue;
+      visit(id,c.len);
+      }
+    };
+  return aStar(ctx.point,wayPoints.size(),begin,end,next,h);
   }
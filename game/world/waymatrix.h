@@ -6,6 +6,13 @@
 #include <zenload/zTypes.h>
 #include <vector>
 #include <functional>
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <atomic>
+
+#include "utils/workers.h"
+#include "utils/strid.h"
 
 #include "waypath.h"
 #include "waypoint.h"
@@ -19,6 +26,7 @@ class WayMatrix final {
 
     const WayPoint* findWayPoint (const Tempest::Vec3& at, const Tempest::Vec3& to, const std::function<bool(const WayPoint&)>& filter) const;
     const WayPoint* findFreePoint(const Tempest::Vec3& at, std::string_view name, const std::function<bool(const WayPoint&)>& filter) const;
+    const WayPoint* findFreePoint(const Tempest::Vec3& at, StrId name,            const std::function<bool(const WayPoint&)>& filter) const;
     const WayPoint* findNextPoint(const Tempest::Vec3& at) const;
 
     void            addFreePoint (const Tempest::Vec3& pos, const Tempest::Vec3& dir, std::string_view name);
@@ -28,9 +36,31 @@ class WayMatrix final {
     void            buildIndex();
 
     const WayPoint* findPoint(std::string_view name, bool inexact) const;
+    const WayPoint* findPoint(StrId name, bool inexact) const;
     void            marchPoints(DbgPainter& p) const;
 
+    class PathRequest final {
+      public:
+        PathRequest() = default;
+        // already completed request, for trivial paths
+        static PathRequest resolved(WayPath&& path);
+
+        bool    isValid() const { return task!=nullptr; }
+        bool    isReady() const;
+        WayPath take();
+
+      private:
+        struct Task {
+          std::atomic_bool ready{false};
+          WayPath          path;
+          };
+        std::shared_ptr<Task> task;
+      friend class WayMatrix;
+      };
+
+    // thread-safe
     WayPath         wayTo(const WayPoint &begin, const WayPoint& end) const;
+    PathRequest     wayToAsync(const WayPoint &begin, const WayPoint& end) const;
 
   private:
     World&                 world;
@@ -41,21 +71,75 @@ class WayMatrix final {
     std::vector<WayPoint>  wayPoints;
     std::vector<WayPoint>  freePoints, startPoints;
     std::vector<WayPoint*> indexPoints;
+    std::unordered_map<StrId,const WayPoint*> pointByName;
+
+    // uniform XZ-grid over points
+    struct Grid {
+      float                        cellSize = 1;
+      int32_t                      minX = 0, minZ = 0, maxX = -1, maxZ = -1;
+      std::vector<const WayPoint*> points;
+      std::unordered_map<uint64_t,std::pair<uint32_t,uint32_t>> cells;
+
+      void    build(std::vector<const WayPoint*> pt, float cellSize);
+      int32_t cellOf(float v) const;
 
-    std::vector<WayPoint*> fpInd;
+      template<class Cost, class Filter>
+      const WayPoint* nearest(const Tempest::Vec3& at, float R, const Cost& cost, const Filter& filter) const;
+      };
+    Grid                                  wpGrid, indexGrid;
 
     struct FpIndex {
-      std::string                  key;
-      std::vector<const WayPoint*> index;
+      StrId                        key;
+      Grid                         index;
+      };
+    mutable std::mutex                    fpSync;
+    mutable std::vector<std::unique_ptr<FpIndex>> fpIndex;
+
+    // HPA*-like abstraction: waypoints, grouped by grid cell and connectivity
+    struct Cluster {
+      struct Link {
+        uint32_t id  = 0;
+        int32_t  len = 0;
+        };
+      Tempest::Vec3     pos;
+      std::vector<Link> link;
+      };
+    std::vector<uint32_t>                 clusterOf;
+    std::vector<Cluster>                  clusters;
+
+    // scratch state of A* search
+    struct SearchState {
+      struct Node {
+        int32_t  g      = 0;
+        int32_t  f      = 0;
+        uint32_t parent = 0;
+        uint32_t heapId = 0;
+        uint32_t gen    = 0;
+        };
+      std::vector<Node>     node;
+      std::vector<uint32_t> heap;
+      uint32_t              gen = 0;
       };
-    mutable std::vector<FpIndex>          fpIndex;
 
-    mutable uint16_t                      pathGen=0;
-    mutable std::vector<const WayPoint*>  stk[2];
+    struct PathCtx {
+      SearchState           point, cluster;
+      std::vector<uint32_t> corridor;
+      uint32_t              corridorGen = 0;
+      };
+    // search contexts are taken per-query, so wayTo can run concurrently
+    mutable std::mutex                    pathSync;
+    mutable std::vector<std::unique_ptr<PathCtx>> pathCtx;
+    mutable Workers::Group                pathAsync;
 
     void                   adjustWaypoints(std::vector<WayPoint> &wp);
-
-    const FpIndex&         findFpIndex(std::string_view name) const;
-    const WayPoint*        findFreePoint(float x, float y, float z, const FpIndex &ind,
+    void                   buildClusters();
+    bool                   findCorridor(PathCtx& ctx, uint32_t begin, uint32_t end) const;
+    bool                   findPath(PathCtx& ctx, uint32_t begin, uint32_t end, bool useCorridor) const;
+    WayPath                implWayTo(PathCtx& ctx, const WayPoint& begin, const WayPoint& end) const;
+    std::unique_ptr<PathCtx> takeCtx() const;
+    void                   releaseCtx(std::unique_ptr<PathCtx>&& ctx) const;
+
+    const FpIndex&         findFpIndex(StrId name) const;
+    const WayPoint*        findFreePoint(const Tempest::Vec3& at, const FpIndex &ind,
                                          const std::function<bool(const WayPoint&)>& filter) const;
   };
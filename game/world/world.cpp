@@ -483,11 +483,7 @@ Interactive *World::aviableMob(const Npc &pl, const char* name) {
   }
 
 Interactive* World::findInteractive(const Npc& pl) {
-  WorldObjects::SearchOpt optMvMob;
-  optMvMob.rangeMax = 100;
-  optMvMob.flags    = WorldObjects::SearchFlg::NoAngle;
-
-  return wobj.findInteractive(pl,nullptr,optMvMob);
+  return wobj.findInteractive(pl,nullptr,WorldObjects::moveMobOpt());
   }
 
 void World::triggerEvent(const TriggerEvent &e) {
@@ -506,6 +502,10 @@ void World::disableTicks(AbstractTrigger& t) {
   wobj.disableTicks(t);
   }
 
+void World::scheduleTicks(AbstractTrigger& t, uint64_t time) {
+  wobj.scheduleTicks(t,time);
+  }
+
 void World::enableCollizionZone(CollisionZone& z) {
   wobj.enableCollizionZone(z);
   }
@@ -770,8 +770,8 @@ void World::addSound(const ZenLoad::zCVobData& vob) {
     }
   }
 
-void World::invalidateVobIndex() {
-  wobj.invalidateVobIndex();
+void World::updateVobIndex(const Vob& v) {
+  wobj.updateVobIndex(v);
   }
 
 void World::triggerOnStart(bool firstTime) {
@@ -790,9 +790,9 @@ const WayPoint* World::findWayPoint(const Tempest::Vec3& pos, const std::functio
   return wmatrix->findWayPoint(pos,pos,f);
   }
 
-const WayPoint *World::findFreePoint(const Npc &npc, std::string_view name) const {
+const WayPoint *World::findFreePoint(const Npc &npc, StrId name) const {
   if(auto p = npc.currentWayPoint()){
-    if(p->isFreePoint() && p->checkName(name)) {
+    if(p->isFreePoint() && p->checkName(name.str())) {
       return p;
       }
     }
@@ -816,7 +816,7 @@ const WayPoint *World::findFreePoint(const Tempest::Vec3& pos, std::string_view
     });
   }
 
-const WayPoint *World::findNextFreePoint(const Npc &npc, std::string_view name) const {
+const WayPoint *World::findNextFreePoint(const Npc &npc, StrId name) const {
   auto pos = npc.position();
   pos.y+=npc.translateY();
   auto cur = npc.currentWayPoint();
@@ -847,10 +847,24 @@ void World::detectItem(const Tempest::Vec3& p, const float r, const std::functio
   }
 
 WayPath World::wayTo(const Npc &npc, const WayPoint &end) const {
+  auto begin = wayBegin(npc,end);
+  if(begin==nullptr)
+    return WayPath();
+  return wmatrix->wayTo(*begin,end);
+  }
+
+WayMatrix::PathRequest World::wayToAsync(const Npc& npc, const WayPoint& end) const {
+  auto begin = wayBegin(npc,end);
+  if(begin==nullptr)
+    return WayMatrix::PathRequest::resolved(WayPath());
+  return wmatrix->wayToAsync(*begin,end);
+  }
+
+const WayPoint* World::wayBegin(const Npc& npc, const WayPoint& end) const {
   auto p     = npc.position();
   auto begin = npc.currentWayPoint();
   if(begin && !begin->isFreePoint() && MoveAlgo::isClose(npc.position(),*begin)) {
-    return wmatrix->wayTo(*begin,end);
+    return begin;
     }
 
   begin = wmatrix->findWayPoint(p,end.position(),[&npc](const WayPoint &wp) {
@@ -859,11 +873,10 @@ WayPath World::wayTo(const Npc &npc, const WayPoint &end) const {
     return true;
     });
   if(begin==nullptr)
-    return WayPath();
+    return nullptr;
   if(MoveAlgo::isClose(p,*begin))
-    return WayPath();
-
-  return wmatrix->wayTo(*begin,end);
+    return nullptr;
+  return begin;
   }
 
 GameScript &World::script() const {
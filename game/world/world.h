@@ -65,10 +65,10 @@ class World final {
     const WayPoint*      findWayPoint(const Tempest::Vec3& pos) const;
     const WayPoint*      findWayPoint(const Tempest::Vec3& pos, const std::function<bool(const WayPoint&)>& f) const;
 
-    const WayPoint*      findFreePoint(const Npc& pos,           std::string_view name) const;
+    const WayPoint*      findFreePoint(const Npc& pos,           StrId name) const;
     const WayPoint*      findFreePoint(const Tempest::Vec3& pos, std::string_view name) const;
 
-    const WayPoint*      findNextFreePoint(const Npc& pos, std::string_view name) const;
+    const WayPoint*      findNextFreePoint(const Npc& pos, StrId name) const;
     const WayPoint*      findNextPoint(const WayPoint& pos) const;
 
     void                 detectNpcNear(std::function<void(Npc&)> f);
@@ -76,6 +76,7 @@ class World final {
     void                 detectItem(const Tempest::Vec3& p, const float r, const std::function<void(Item&)>& f);
 
     WayPath              wayTo(const Npc& pos,const WayPoint& end) const;
+    auto                 wayToAsync(const Npc& pos,const WayPoint& end) const -> WayMatrix::PathRequest;
 
     WorldView*           view()     const { return wview.get();    }
     WorldSound*          sound()          { return &wsound;        }
@@ -104,6 +105,9 @@ class World final {
     MeshObjects::Mesh    addDecalView (const ZenLoad::zCVobData& vob);
 
     void                 updateAnimation();
+    auto                 aiLodStats() const -> const WorldObjects::AiLodStats& { return wobj.aiLodStats(); }
+    PoseCache&           poseCache()       { return wobj.poseCache(); }
+    const PoseCache&     poseCache() const { return wobj.poseCache(); }
     void                 resetPositionToTA();
 
     auto                 takeHero() -> std::unique_ptr<Npc>;
@@ -127,6 +131,7 @@ class World final {
     void                 execTriggerEvent(const TriggerEvent& e);
     void                 enableTicks (AbstractTrigger& t);
     void                 disableTicks(AbstractTrigger& t);
+    void                 scheduleTicks(AbstractTrigger& t, uint64_t time);
     void                 enableCollizionZone (CollisionZone& z);
     void                 disableCollizionZone(CollisionZone& z);
 
@@ -174,7 +179,7 @@ class World final {
     void                 addFreePoint  (const Tempest::Vec3& pos, const Tempest::Vec3& dir, std::string_view name);
     void                 addSound      (const ZenLoad::zCVobData& vob);
 
-    void                 invalidateVobIndex();
+    void                 updateVobIndex(const Vob& v);
 
   private:
     std::string                           wname;
@@ -197,6 +202,7 @@ class World final {
     auto         portalAt(std::string_view tag) -> BspSector*;
 
     void         initScripts(bool firstTime);
+    auto         wayBegin(const Npc& pos, const WayPoint& end) const -> const WayPoint*;
 
     Sound        addHitEffect(std::string_view src, std::string_view reciver, std::string_view scheme, const Tempest::Matrix4x4& pos);
   };
@@ -14,12 +14,16 @@
 #include "world/objects/vob.h"
 #include "world/collisionzone.h"
 #include "world.h"
+#include "gothic.h"
 #include "utils/workers.h"
 #include "utils/dbgpainter.h"
 
 #include <Tempest/Painter>
 #include <Tempest/Application>
 #include <Tempest/Log>
+#include <cmath>
+#include <mutex>
+#include <tuple>
 
 using namespace Tempest;
 using namespace Daedalus::GameState;
@@ -61,37 +65,125 @@ WorldObjects::SearchOpt::SearchOpt(float rangeMin, float rangeMax, float azi, Ta
 
 WorldObjects::WorldObjects(World& owner):owner(owner){
   npcNear.reserve(512);
+  Gothic::inst().onSettingsChanged.bind(this,&WorldObjects::setupSettings);
+  setupSettings();
   }
 
 WorldObjects::~WorldObjects() {
+  Gothic::inst().onSettingsChanged.ubind(this,&WorldObjects::setupSettings);
+  }
+
+void WorldObjects::setupSettings() {
+  // distances are in meters in ini; zero means default
+  aiLod = AiLod();
+  if(float r = Gothic::settingsGetF("GAME","aiNearRange"); r>0)
+    aiLod.nearDist = r*100.f;
+  if(float r = Gothic::settingsGetF("GAME","aiFarRange"); r>0)
+    aiLod.farDist = r*100.f;
+  if(int rate = Gothic::settingsGetI("GAME","aiFarRate"); rate>0)
+    aiLod.farRate = uint32_t(rate);
+  if(int rate = Gothic::settingsGetI("GAME","aiFar2Rate"); rate>0)
+    aiLod.far2Rate = uint32_t(rate);
+  aiLod.farDist = std::max(aiLod.farDist,aiLod.nearDist);
+
+  animLod = AnimLod();
+  if(float r = Gothic::settingsGetF("GAME","animNearRange"); r>0)
+    animLod.nearDist = r*100.f;
+  if(float r = Gothic::settingsGetF("GAME","animFarRange"); r>0)
+    animLod.farDist = r*100.f;
+  if(int rate = Gothic::settingsGetI("GAME","animFarRate"); rate>0)
+    animLod.farRate = uint32_t(rate);
+  animLod.farDist = std::max(animLod.farDist,animLod.nearDist);
+  }
+
+void WorldObjects::tickGroundRays(uint64_t dt, uint64_t dtPlayer) {
+  // ground and water probes of all npc, that going to be ticked, in one parallel batch
+  groundRays.clear();
+  groundNpc.clear();
+  for(size_t i=0; i<npcArr.size(); ++i) {
+    auto&  npc = *npcArr[i];
+    size_t id  = groundRays.size();
+    if(!npc.isPlayer() && !isLodSlice(npc,lodTick))
+      continue;
+    if(npc.prefetchRays(groundRays,npc.isPlayer() ? dtPlayer : dt))
+      groundNpc.emplace_back(&npc,id);
+    }
+  if(groundNpc.empty())
+    return;
+  owner.physic()->rayBatch(groundRays);
+  for(auto& i:groundNpc)
+    i.first->applyRays(groundRays,i.second);
+  }
+
+bool WorldObjects::isLodSlice(const Npc& npc, uint64_t frame) const {
+  uint32_t rate = 1;
+  switch(npc.processPolicy()) {
+    case Npc::ProcessPolicy::Player:
+    case Npc::ProcessPolicy::AiNormal:
+      return true;
+    case Npc::ProcessPolicy::AiFar:
+      rate = aiLod.farRate;
+      break;
+    case Npc::ProcessPolicy::AiFar2:
+      rate = aiLod.far2Rate;
+      break;
+    }
+  // phase by spawn serial: stable, while npc are spawned/removed and npcArr is reordered
+  return (npc.lodPhase()+frame)%rate==0;
+  }
+
+bool WorldObjects::animLodOf(const Tempest::Vec3& pos, const Tempest::Vec3& viewer, bool visible, bool canFreeze,
+                             size_t phase, uint64_t frame, Pose::Lod& lod) const {
+  const float dist  = (pos-viewer).quadLength();
+  const bool  isFar = dist>=animLod.farDist*animLod.farDist;
+  if(!visible && (canFreeze || isFar)) {
+    lod = Pose::LodFrozen;
+    return true;
+    }
+  if(visible && dist<animLod.nearDist*animLod.nearDist) {
+    lod = Pose::LodFull;
+    return true;
+    }
+  lod = Pose::LodReduced;
+  if(visible && !isFar)
+    return true;
+  return (phase+frame)%animLod.farRate==0;
   }
 
 void WorldObjects::load(Serialize &fin) {
   uint32_t sz = uint32_t(npcArr.size());
 
-  fin.read(sz);
-  npcArr.clear();
-  for(size_t i=0;i<sz;++i)
-    npcArr.emplace_back(std::make_unique<Npc>(owner,size_t(-1),""));
-  for(auto& i:npcArr)
-    i->load(fin);
+  fin.readSection([&](){
+    fin.read(sz);
+    npcArr.clear();
+    for(size_t i=0;i<sz;++i)
+      npcArr.emplace_back(std::make_unique<Npc>(owner,size_t(-1),""));
+    for(auto& i:npcArr)
+      i->load(fin);
+    });
 
-  fin.read(sz);
-  itemArr.clear();
-  for(size_t i=0;i<sz;++i){
-    auto it = std::make_unique<Item>(owner,fin,Item::T_World);
-    itemArr.emplace_back(std::move(it));
-    items.add(itemArr.back().get());
-    }
+  fin.readSection([&](){
+    fin.read(sz);
+    itemArr.clear();
+    for(size_t i=0;i<sz;++i){
+      auto it = std::make_unique<Item>(owner,fin,Item::T_World);
+      itemArr.emplace_back(std::move(it));
+      items.add(itemArr.back().get());
+      }
+    });
 
-  fin.read(sz);
-  if(fin.version()>=28 && interactiveObj.size()!=sz)
-    throw std::logic_error("inconsistent *.sav vs world");
-  for(auto& i:rootVobs)
-    i->loadVobTree(fin);
+  fin.readSection([&](){
+    fin.read(sz);
+    if(fin.version()>=28 && interactiveObj.size()!=sz)
+      throw std::logic_error("inconsistent *.sav vs world");
+    for(auto& i:rootVobs)
+      i->loadVobTree(fin);
+    });
   if(fin.version()>=10) {
     uint32_t sz = 0;
     fin.read(sz);
+    // delayed events are re-queued by execTriggerEvent
+    triggerDelayed.clear();
     triggerEvents.resize(sz);
     for(auto& i:triggerEvents)
       i.load(fin);
@@ -111,23 +203,28 @@ void WorldObjects::load(Serialize &fin) {
   }
 
 void WorldObjects::save(Serialize &fout) {
-  uint32_t sz = uint32_t(npcArr.size());
-  fout.write(sz);
-  for(auto& i:npcArr)
-    i->save(fout);
+  fout.writeSection([&](){
+    fout.write(uint32_t(npcArr.size()));
+    for(auto& i:npcArr)
+      i->save(fout);
+    });
 
-  sz = uint32_t(itemArr.size());
-  fout.write(sz);
-  for(auto& i:itemArr)
-    i->save(fout);
+  fout.writeSection([&](){
+    fout.write(uint32_t(itemArr.size()));
+    for(auto& i:itemArr)
+      i->save(fout);
+    });
 
-  sz = uint32_t(interactiveObj.size());
-  fout.write(sz);
-  for(auto& i:rootVobs)
-    i->saveVobTree(fout);
-  fout.write(uint32_t(triggerEvents.size()));
+  fout.writeSection([&](){
+    fout.write(uint32_t(interactiveObj.size()));
+    for(auto& i:rootVobs)
+      i->saveVobTree(fout);
+    });
+  fout.write(uint32_t(triggerEvents.size()+triggerDelayed.size()));
   for(auto& i:triggerEvents)
     i.save(fout);
+  for(auto& i:triggerDelayed)
+    i.second.save(fout);
 
   fout.write(uint32_t(routines.size()));
   for(auto& i:routines)
@@ -141,12 +238,37 @@ void WorldObjects::tick(uint64_t dt, uint64_t dtPlayer) {
   std::sort(npcArr.begin(),npcArr.end(),[](std::unique_ptr<Npc>& a, std::unique_ptr<Npc>& b){
     return a->handle()->id<b->handle()->id;
     });
+  lodStats.ticked      = 0;
+  lodStats.rayPrefetch = 0;
+  lodStats.rayHits     = 0;
+  tickGroundRays(dt,dtPlayer);
   for(size_t i=0; i<npcArr.size(); ++i) {
     auto& npc = *npcArr[i];
-    if(npc.isPlayer())
-      npc.tick(dtPlayer); else
+    if(npc.isPlayer()) {
+      npc.tick(dtPlayer);
+      }
+    else if(isLodSlice(npc,lodTick)) {
       npc.tick(dt);
+      }
+    else {
+      npc.skipTick(dt);
+      continue;
+      }
+    lodStats.ticked++;
+    switch(npc.takeRayPrefetch()) {
+      case MoveAlgo::RP_None:
+        break;
+      case MoveAlgo::RP_Hit:
+        lodStats.rayHits++;
+        lodStats.rayPrefetch++;
+        break;
+      case MoveAlgo::RP_Pending:
+      case MoveAlgo::RP_Miss:
+        lodStats.rayPrefetch++;
+        break;
+      }
     }
+  lodTick++;
 
   for(auto& i:routines) {
     auto s = i.stateByTime(owner.time());
@@ -159,8 +281,19 @@ void WorldObjects::tick(uint64_t dt, uint64_t dtPlayer) {
   for(auto& i:interactiveObj)
     i->tick(dt);
 
-  for(auto i:triggersTk)
-    i->tick(dt);
+  while(!triggersWake.empty() && triggersWake.top().time<=owner.tickCount()) {
+    auto w = triggersWake.top();
+    triggersWake.pop();
+    w.tg->wake(w.time);
+    }
+  // triggers enable/disable ticks of themselves and others meanwhile:
+  // removed slots are nulled and compacted after the loop, new ones are appended
+  triggersTkLock = true;
+  for(size_t i=0, cnt=triggersTk.size(); i<cnt; ++i)
+    if(auto t = triggersTk[i])
+      t->tick(dt);
+  triggersTkLock = false;
+  triggersTk.erase(std::remove(triggersTk.begin(),triggersTk.end(),nullptr),triggersTk.end());
 
   bullets.remove_if([](Bullet& b){
     return b.isFinished();
@@ -182,9 +315,12 @@ void WorldObjects::tick(uint64_t dt, uint64_t dtPlayer) {
     return;
 
   npcNear.clear();
-  const float nearDist = 3000*3000;
-  const float farDist  = 6000*6000;
+  const float nearDist = aiLod.nearDist*aiLod.nearDist;
+  const float farDist  = aiLod.farDist *aiLod.farDist;
 
+  lodStats.aiNormal = 0;
+  lodStats.aiFar    = 0;
+  lodStats.aiFar2   = 0;
   auto plPos = pl->position();
   for(auto& i:npcArr) {
     float dist = (i->position()-plPos).quadLength();
@@ -192,11 +328,14 @@ void WorldObjects::tick(uint64_t dt, uint64_t dtPlayer) {
       npcNear.push_back(i.get());
       if(i.get()!=pl)
         i->setProcessPolicy(Npc::ProcessPolicy::AiNormal);
+      lodStats.aiNormal++;
       } else
     if(dist<farDist) {
       i->setProcessPolicy(Npc::ProcessPolicy::AiFar);
+      lodStats.aiFar++;
       } else {
       i->setProcessPolicy(Npc::ProcessPolicy::AiFar2);
+      lodStats.aiFar2++;
       }
     }
   tickNear(dt);
@@ -204,37 +343,124 @@ void WorldObjects::tick(uint64_t dt, uint64_t dtPlayer) {
     z->tick(dt);
   tickTriggers(dt);
 
-  for(auto& ptr:npcArr) {
-    Npc& i = *ptr;
-    if(i.isPlayer() || i.isDead())
+  tickPerception(passive,*pl);
+  }
+
+void WorldObjects::PercGrid::build(const std::vector<PerceptionMsg>& passive, float cSize) {
+  cellSize = cSize;
+  msg.clear();
+  for(size_t i=0; i<passive.size(); ++i) {
+    auto& r = passive[i];
+    if(r.other==nullptr || r.victum==nullptr)
       continue;
+    uint64_t key = (uint64_t(uint32_t(cellOf(r.pos.x)))<<32) | uint64_t(uint32_t(cellOf(r.pos.z)));
+    msg.emplace_back(key,uint32_t(i));
+    }
+  std::sort(msg.begin(),msg.end());
+  }
 
-    if(i.processPolicy()==Npc::AiNormal) {
-      for(auto& r:passive) {
-        if(r.self==&i)
-          continue;
-        float l = i.qDistTo(r.pos.x,r.pos.y,r.pos.z);
-        if(r.item!=size_t(-1) && r.other!=nullptr)
-          owner.script().setInstanceItem(*r.other,r.item);
-        const float range = float(i.handle()->senses_range);
-        if(l<range*range && r.other!=nullptr && r.victum!=nullptr) {
-          // aproximation of behavior of original G2
-          if(!i.isDown() && !i.isPlayer() &&
-             i.canSenseNpc(*r.other, true)!=SensesBit::SENSE_NONE &&
-             i.canSenseNpc(*r.victum,true,float(r.other->handle()->senses_range))!=SensesBit::SENSE_NONE
-            ) {
-            i.perceptionProcess(*r.other,r.victum,l,PercType(r.what));
-            }
-          }
+int32_t WorldObjects::PercGrid::cellOf(float v) const {
+  float c = std::floor(v/cellSize);
+  c = std::max(c,-float(1<<29));
+  c = std::min(c, float(1<<29));
+  return int32_t(c);
+  }
+
+template<class F>
+void WorldObjects::PercGrid::find(const Vec3& p, float R, const F& f) const {
+  if(msg.empty())
+    return;
+  const int32_t x0 = cellOf(p.x-R), x1 = cellOf(p.x+R);
+  const int32_t z0 = cellOf(p.z-R), z1 = cellOf(p.z+R);
+  for(int32_t x=x0; x<=x1; ++x)
+    for(int32_t z=z0; z<=z1; ++z) {
+      uint64_t key = (uint64_t(uint32_t(x))<<32) | uint64_t(uint32_t(z));
+      auto     it  = std::lower_bound(msg.begin(),msg.end(),std::make_pair(key,uint32_t(0)));
+      for(; it!=msg.end() && it->first==key; ++it)
+        f(it->second);
+      }
+  }
+
+void WorldObjects::tickPerception(const std::vector<PerceptionMsg>& passive, Npc& pl) {
+  // bucket messages, so each npc only tests the ones inside of it's senses_range
+  float maxRange = 0;
+  if(!passive.empty()) {
+    for(auto& i:npcArr)
+      if(i->processPolicy()==Npc::AiNormal)
+        maxRange = std::max(maxRange,float(i->handle()->senses_range));
+    }
+  percGrid.build(passive,std::max(maxRange,100.f));
+
+  // sense pass: ray-casts only, no script calls - runs in parallel
+  percCmd.clear();
+  std::mutex sync;
+  Workers::parallelRange(npcArr.size(),8,[&](size_t b, size_t e){
+    std::vector<PercCmd> cmd;
+    for(size_t id=b; id<e; ++id) {
+      Npc& i = *npcArr[id];
+      if(i.isPlayer() || i.isDead())
+        continue;
+
+      if(i.processPolicy()==Npc::AiNormal) {
+        percGrid.find(i.position(),float(i.handle()->senses_range),[&](uint32_t r){
+          if(isPassiveSensed(i,passive[r]))
+            cmd.push_back(PercCmd{uint32_t(id),r});
+          });
         }
+
+      if(i.percNextTime()>owner.tickCount())
+        continue;
+      i.perceptionScan(pl);
+      cmd.push_back(PercCmd{uint32_t(id),PercCmd::Active});
       }
+    std::lock_guard<std::mutex> guard(sync);
+    percCmd.insert(percCmd.end(),cmd.begin(),cmd.end());
+    });
 
-    if(i.percNextTime()>owner.tickCount())
+  // apply pass: script calls in deterministic order
+  std::sort(percCmd.begin(),percCmd.end(),[](const PercCmd& a, const PercCmd& b){
+    return std::tie(a.npc,a.passive)<std::tie(b.npc,b.passive);
+    });
+
+  // PERC_MOVEMOB: mobsi lookups of all npc in one batched index query
+  mobNpc.clear();
+  for(auto& c:percCmd)
+    if(c.passive==PercCmd::Active && npcArr[c.npc]->needMoveMob())
+      mobNpc.push_back(npcArr[c.npc].get());
+  findInteractive(mobNpc.data(),mobNpc.size(),moveMobOpt(),mobHit);
+  for(size_t i=0; i<mobNpc.size(); ++i)
+    mobNpc[i]->setMoveMob(mobHit[i]);
+  for(auto& c:percCmd) {
+    Npc& i = *npcArr[c.npc];
+    if(i.isDead())
+      continue;
+    if(c.passive==PercCmd::Active) {
+      i.perceptionProcess(pl);
       continue;
-    i.perceptionProcess(*pl);
+      }
+    auto& r = passive[c.passive];
+    if(i.isDown())
+      continue;
+    if(r.item!=size_t(-1))
+      owner.script().setInstanceItem(*r.other,r.item);
+    float l = i.qDistTo(r.pos.x,r.pos.y,r.pos.z);
+    i.perceptionProcess(*r.other,r.victum,l,PercType(r.what));
     }
   }
 
+bool WorldObjects::isPassiveSensed(Npc& i, const PerceptionMsg& r) {
+  if(r.self==&i || r.other==nullptr || r.victum==nullptr)
+    return false;
+  float l = i.qDistTo(r.pos.x,r.pos.y,r.pos.z);
+  const float range = float(i.handle()->senses_range);
+  if(l>=range*range)
+    return false;
+  // aproximation of behavior of original G2
+  return !i.isDown() &&
+         i.canSenseNpc(*r.other, true)!=SensesBit::SENSE_NONE &&
+         i.canSenseNpc(*r.victum,true,float(r.other->handle()->senses_range))!=SensesBit::SENSE_NONE;
+  }
+
 uint32_t WorldObjects::npcId(const Npc *ptr) const {
   if(ptr==nullptr)
     return uint32_t(-1);
@@ -346,6 +572,13 @@ void WorldObjects::tickTriggers(uint64_t /*dt*/) {
 
   for(auto& e:evt)
     execTriggerEvent(e);
+
+  const uint64_t time = owner.tickCount();
+  while(!triggerDelayed.empty() && triggerDelayed.begin()->first<=time) {
+    auto e = std::move(triggerDelayed.begin()->second);
+    triggerDelayed.erase(triggerDelayed.begin());
+    execTriggerEvent(e);
+    }
   }
 
 void WorldObjects::triggerEvent(const TriggerEvent &e) {
@@ -354,32 +587,58 @@ void WorldObjects::triggerEvent(const TriggerEvent &e) {
 
 void WorldObjects::execTriggerEvent(const TriggerEvent& e) {
   if(e.timeBarrier>owner.tickCount()) {
-    triggerEvent(std::move(e));
+    triggerDelayed.emplace(e.timeBarrier,e);
     return;
     }
 
-  bool emitted=false;
-  for(auto& i:triggers) {
-    auto& t = *i;
-    if(t.name()==e.target) { // NOTE: trigger name is not unique - more then one trigger can be activated
-      t.processEvent(e);
-      emitted=true;
-      }
-    }
-  if(!emitted)
+  auto it = triggerByName.find(e.targetId);
+  if(it==triggerByName.end() || it->second.empty()) {
     Log::d("unable to process trigger: \"",e.target,"\"");
+    return;
+    }
+  // NOTE: index-based loop: receiver may register new triggers
+  auto& receivers = it->second;
+  for(size_t i=0; i<receivers.size(); ++i)
+    receivers[i]->processEvent(e);
   }
 
 void WorldObjects::updateAnimation() {
   static bool doAnim=true;
   if(!doAnim)
     return;
-  Workers::parallelFor(npcArr,[](std::unique_ptr<Npc>& i){
-    i->updateAnimation();
+  // npc and mobsi poses are independent - no need for barrier in between
+  // far npc's are animated in same round-robin slices as ai; pose catches up by time
+  // culled unarmed npc's keep last pose; mobsi are frozen only when far, since pose drives their physics
+  const uint64_t frame  = lodFrame++;
+  const Npc*     pl     = owner.player();
+  poses.reset();
+  const auto     viewer = pl!=nullptr ? pl->position() : Tempest::Vec3();
+  Workers::Group anim;
+  Workers::spawn(anim,[this,frame,pl,viewer](){
+    Workers::parallelRange(npcArr.size(),16,[this,frame,pl,viewer](size_t b, size_t e){
+      for(size_t i=b; i<e; ++i) {
+        auto&     npc = *npcArr[i];
+        Pose::Lod lod = Pose::LodFull;
+        if(!isLodSlice(npc,frame))
+          continue;
+        // bones of armed npc are read to spawn arrows and spells: never freeze their pose
+        const bool armed = npc.weaponState()!=WeaponState::NoWeapon || npc.isCasting();
+        // same phase, as in isLodSlice: otherwise both gates may never meet for far npc
+        if(&npc!=pl && !animLodOf(npc.position(),viewer,npc.isVisible() || armed,true,npc.lodPhase(),frame,lod))
+          continue;
+        npc.updateAnimation(lod);
+        }
+      });
     });
-  interactiveObj.parallelFor([](Interactive& i){
-    i.updateAnimation();
+  Workers::parallelRange(interactiveObj.size(),16,[this,frame,viewer](size_t b, size_t e){
+    auto mob = interactiveObj.begin();
+    for(size_t i=b; i<e; ++i) {
+      Pose::Lod lod = Pose::LodFull;
+      if(animLodOf(mob[i]->position(),viewer,mob[i]->isVisible(),false,i,frame,lod))
+        mob[i]->updateAnimation(lod);
+      }
     });
+  Workers::wait(anim);
   }
 
 bool WorldObjects::isTargeted(Npc& dst) {
@@ -445,6 +704,7 @@ void WorldObjects::addTrigger(AbstractTrigger* tg) {
   if(tg->hasVolume())
     triggersZn.emplace_back(tg);
   triggers.emplace_back(tg);
+  triggerByName[StrId(tg->name())].push_back(tg);
   }
 
 void WorldObjects::triggerOnStart(bool firstTime) {
@@ -463,12 +723,20 @@ void WorldObjects::enableTicks(AbstractTrigger& t) {
 void WorldObjects::disableTicks(AbstractTrigger& t) {
   for(auto& i:triggersTk)
     if(i==&t) {
+      if(triggersTkLock) {
+        i = nullptr;
+        return;
+        }
       i = triggersTk.back();
       triggersTk.pop_back();
       return;
       }
   }
 
+void WorldObjects::scheduleTicks(AbstractTrigger& t, uint64_t time) {
+  triggersWake.push(TickWake{time,&t});
+  }
+
 void WorldObjects::enableCollizionZone(CollisionZone& z) {
   collisionZn.push_back(&z);
   }
@@ -620,9 +888,9 @@ void WorldObjects::addRoot(ZenLoad::zCVobData&& vob, bool startup) {
   rootVobs.emplace_back(std::move(p));
   }
 
-void WorldObjects::invalidateVobIndex() {
-  items.invalidate();
-  interactiveObj.invalidate();
+void WorldObjects::updateVobIndex(const Vob& v) {
+  items.update(&v);
+  interactiveObj.update(&v);
   }
 
 Interactive* WorldObjects::validateInteractive(Interactive *def) {
@@ -662,6 +930,36 @@ Interactive* WorldObjects::findInteractive(const Npc &pl, Interactive* def, cons
   return ret;
   }
 
+void WorldObjects::findInteractive(Npc* const* pl, size_t cnt, const SearchOpt& opt, std::vector<Interactive*>& out) {
+  out.assign(cnt,nullptr);
+  if(cnt==0 || owner.view()==nullptr)
+    return;
+
+  mobPos.resize(cnt);
+  mobR.assign(cnt,opt.rangeMax);
+  for(size_t i=0; i<cnt; ++i)
+    mobPos[i] = pl[i]->position();
+  interactiveObj.find(mobPos.data(),mobR.data(),cnt,mobQuery);
+
+  for(size_t i=0; i<cnt; ++i) {
+    float rlen = opt.rangeMax*opt.rangeMax;
+    for(auto it=mobQuery.begin(i), e=mobQuery.end(i); it!=e; ++it) {
+      float nlen = rlen;
+      if(testObj(**it,*pl[i],opt,nlen)) {
+        rlen   = nlen;
+        out[i] = *it;
+        }
+      }
+    }
+  }
+
+WorldObjects::SearchOpt WorldObjects::moveMobOpt() {
+  SearchOpt opt;
+  opt.rangeMax = 100;
+  opt.flags    = SearchFlg::NoAngle;
+  return opt;
+  }
+
 Npc* WorldObjects::findNpc(const Npc &pl, Npc *def, const SearchOpt& opt) {
   def = validateNpc(def);
   if(def) {
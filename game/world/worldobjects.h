@@ -2,6 +2,9 @@
 
 #include <vector>
 #include <memory>
+#include <map>
+#include <queue>
+#include <unordered_map>
 
 #include <daedalus/DaedalusGameState.h>
 
@@ -10,6 +13,10 @@
 #include "game/gametime.h"
 #include "game/perceptionmsg.h"
 #include "game/constants.h"
+#include "graphics/mesh/pose.h"
+#include "graphics/mesh/posecache.h"
+#include "utils/strid.h"
+#include "triggers/abstracttrigger.h"
 
 class Npc;
 class Item;
@@ -18,8 +25,6 @@ class StaticObj;
 class Interactive;
 class World;
 class Serialize;
-class TriggerEvent;
-class AbstractTrigger;
 class CollisionZone;
 
 class WorldObjects final {
@@ -46,6 +51,16 @@ class WorldObjects final {
       SearchFlg     flags       = NoFlg;
       };
 
+    // npc count per ai-lod bucket, for last tick
+    struct AiLodStats final {
+      uint32_t      aiNormal    = 0;
+      uint32_t      aiFar       = 0;
+      uint32_t      aiFar2      = 0;
+      uint32_t      ticked      = 0;
+      uint32_t      rayPrefetch = 0; // npc with batched ground probes
+      uint32_t      rayHits     = 0; // prefetched probes, that were used by tick
+      };
+
     void           load(Serialize& fout);
     void           save(Serialize& fout);
     void           tick(uint64_t dt, uint64_t dtPlayer);
@@ -56,6 +71,9 @@ class WorldObjects final {
     auto           takeNpc(const Npc* npc) -> std::unique_ptr<Npc>;
 
     void           updateAnimation();
+    auto           aiLodStats() const -> const AiLodStats& { return lodStats; }
+    PoseCache&       poseCache()       { return poses; }
+    const PoseCache& poseCache() const { return poses; }
 
     bool           isTargeted(Npc& npc);
     Npc*           findHero();
@@ -83,6 +101,7 @@ class WorldObjects final {
     void           execTriggerEvent(const TriggerEvent& e);
     void           enableTicks (AbstractTrigger& t);
     void           disableTicks(AbstractTrigger& t);
+    void           scheduleTicks(AbstractTrigger& t, uint64_t time);
     void           enableCollizionZone (CollisionZone& z);
     void           disableCollizionZone(CollisionZone& z);
 
@@ -104,13 +123,15 @@ class WorldObjects final {
     void           addInteractive(Interactive*         obj);
     void           addStatic     (StaticObj*           obj);
     void           addRoot       (ZenLoad::zCVobData&& vob, bool startup);
-    void           invalidateVobIndex();
+    void           updateVobIndex(const Vob& v);
 
     Interactive*   validateInteractive(Interactive *def);
     Npc*           validateNpc        (Npc         *def);
     Item*          validateItem       (Item        *def);
 
     Interactive*   findInteractive(const Npc& pl, Interactive *def, const SearchOpt& opt);
+    void           findInteractive(Npc* const* pl, size_t cnt, const SearchOpt& opt, std::vector<Interactive*>& out);
+    static SearchOpt moveMobOpt();
     Npc*           findNpc        (const Npc& pl, Npc* def, const SearchOpt& opt);
     Item*          findItem       (const Npc& pl, Item* def, const SearchOpt& opt);
 
@@ -143,6 +164,45 @@ class WorldObjects final {
       uint64_t timeUntil = 0;
       };
 
+    // distance based ai level-of-detail; far buckets are updated in round-robin slices
+    struct AiLod {
+      float    nearDist = 3000;
+      float    farDist  = 6000;
+      uint32_t farRate  = 2;
+      uint32_t far2Rate = 8;
+      };
+
+    // animation level-of-detail: distance to player and visibility in last frame
+    struct AnimLod {
+      float    nearDist = 1500;
+      float    farDist  = 4000;
+      uint32_t farRate  = 2;
+      };
+
+    // passive perception messages, bucketed by XZ-cell of sender position
+    struct PercGrid {
+      float                                     cellSize = 1;
+      std::vector<std::pair<uint64_t,uint32_t>> msg;
+
+      void    build(const std::vector<PerceptionMsg>& passive, float cellSize);
+      int32_t cellOf(float v) const;
+      template<class F>
+      void    find(const Tempest::Vec3& p, float R, const F& f) const;
+      };
+
+    struct TickWake {
+      uint64_t         time = 0;
+      AbstractTrigger* tg   = nullptr;
+      bool operator < (const TickWake& other) const { return time>other.time; }
+      };
+
+    // deferred perception call, recorded by parallel sense pass
+    struct PercCmd {
+      static constexpr uint32_t Active = uint32_t(-1);
+      uint32_t npc     = 0;
+      uint32_t passive = Active;
+      };
+
     World&                             owner;
 
     std::vector<CollisionZone*>        collisionZn;
@@ -162,11 +222,33 @@ class WorldObjects final {
     std::vector<std::unique_ptr<Npc>>  npcInvalid;
     std::vector<Npc*>                  npcNear;
 
+    AiLod                              aiLod;
+    AnimLod                            animLod;
+    PoseCache                          poses;
+    AiLodStats                         lodStats;
+    uint64_t                           lodTick  = 0;
+    uint64_t                           lodFrame = 0;
+    DynamicWorld::RayBatch             groundRays;
+    std::vector<std::pair<Npc*,size_t>> groundNpc;
+
     std::vector<AbstractTrigger*>      triggers;
     std::vector<AbstractTrigger*>      triggersZn;
     std::vector<AbstractTrigger*>      triggersTk;
+    bool                               triggersTkLock = false;
+    std::priority_queue<TickWake>      triggersWake;
     std::vector<PerceptionMsg>         sndPerc;
+    std::vector<PercCmd>               percCmd;
+    std::vector<Npc*>                  mobNpc;
+    std::vector<Interactive*>          mobHit;
+    std::vector<Tempest::Vec3>         mobPos;
+    std::vector<float>                 mobR;
+    SpaceIndex<Interactive>::Batch     mobQuery;
+    PercGrid                           percGrid;
+    // trigger name is not unique - more then one trigger can be activated
+    std::unordered_map<StrId,std::vector<AbstractTrigger*>> triggerByName;
     std::vector<TriggerEvent>          triggerEvents;
+    // events with timeBarrier, ordered by time; equal times keep fifo order
+    std::multimap<uint64_t,TriggerEvent> triggerDelayed;
 
     template<class T>
     auto findObj(T &src, const Npc &pl, const SearchOpt& opt) -> typename std::remove_reference<decltype(src[0])>::type*;
@@ -178,7 +260,15 @@ class WorldObjects final {
 
     void             setMobState(const char* scheme, int32_t st);
 
+    void             setupSettings();
+    bool             isLodSlice(const Npc& npc, uint64_t frame) const;
+    void             tickGroundRays(uint64_t dt, uint64_t dtPlayer);
+    bool             animLodOf(const Tempest::Vec3& pos, const Tempest::Vec3& viewer, bool visible, bool canFreeze,
+                               size_t phase, uint64_t frame, Pose::Lod& lod) const;
+
     void             tickNear(uint64_t dt);
     void             tickTriggers(uint64_t dt);
+    void             tickPerception(const std::vector<PerceptionMsg>& passive, Npc& pl);
+    static bool      isPassiveSensed(Npc& npc, const PerceptionMsg& msg);
     static bool      isTargetedBy(Npc& npc,Npc& by);
   };
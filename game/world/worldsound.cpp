@@ -195,6 +195,7 @@ void WorldSound::tick(Npc &player) {
   tickSlot(effect3d);
   for(auto& i:freeSlot)
     tickSlot(*i.second);
+  tickOcclusion();
   tickSoundZone(player);
   }
 
@@ -279,17 +280,26 @@ void WorldSound::tickSlot(Effect& slot) {
   if(slot.ambient) {
     slot.setOcclusion(1.f);
     } else {
-    auto  dyn = owner.physic();
-    auto  pos = slot.pos;
-    float occ = dyn->soundOclusion(plPos+Tempest::Vec3(0,180,0)/*head pos*/, pos);
-    slot.setOcclusion(std::max(0.f,1.f-occ));
+    // resolved in tickOcclusion
+    occSlot.push_back(&slot);
     }
   }
 
+void WorldSound::tickOcclusion() {
+  occPos.resize(occSlot.size());
+  occVal.resize(occSlot.size());
+  for(size_t i=0; i<occSlot.size(); ++i)
+    occPos[i] = occSlot[i]->pos;
+  occCache.occlusion(*owner.physic(), plPos+Tempest::Vec3(0,180,0)/*head pos*/, occPos.data(), occVal.data(), occPos.size());
+  for(size_t i=0; i<occSlot.size(); ++i)
+    occSlot[i]->setOcclusion(std::max(0.f,1.f-occVal[i]));
+  occSlot.clear();
+  }
+
 void WorldSound::initSlot(WorldSound::Effect& slot) {
   auto  dyn = owner.physic();
   auto  pos = slot.pos;
-  float occ = dyn->soundOclusion(plPos+Tempest::Vec3(0,180,0)/*head pos*/, pos);
+  float occ = occCache.occlusion(*dyn, plPos+Tempest::Vec3(0,180,0)/*head pos*/, pos);
   slot.setOcclusion(std::max(0.f,1.f-occ));
   }
 
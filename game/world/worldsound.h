@@ -8,6 +8,7 @@
 #include <mutex>
 
 #include "game/gametime.h"
+#include "soundocclusion.h"
 #include "gamemusic.h"
 
 class GameSession;
@@ -57,6 +58,7 @@ class WorldSound final {
     void    tickSoundZone(Npc& player);
     void    tickSlot(std::vector<PEffect>& eff);
     void    tickSlot(Effect& slot);
+    void    tickOcclusion();
     void    initSlot(Effect& slot);
     bool    setMusic(std::string_view zone, GameMusic::Tags tags);
 
@@ -79,6 +81,11 @@ class WorldSound final {
     std::vector<PEffect>                    effect;
     std::vector<PEffect>                    effect3d; // snd_play3d
     std::vector<WSound>                     worldEff;
+    // non-ambient slots of current tick, occlusion is resolved in batch
+    std::vector<Effect*>                    occSlot;
+    std::vector<Tempest::Vec3>              occPos;
+    std::vector<float>                      occVal;
+    SoundOcclusion                          occCache;
 
     std::mutex                              sync;
 